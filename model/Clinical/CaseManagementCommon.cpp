@@ -21,6 +21,7 @@
 #include "Clinical/CaseManagementCommon.h"
 #include "util/checkpoint_containers.h"
 #include "util/ModelOptions.h"
+#include "util/parallel.h"
 
 namespace OM { namespace Clinical {
 
@@ -39,6 +40,7 @@ util::AgeGroupInterpolator pSequelaeInpatient;
 vector<int> infantDeaths;
 vector<int> infantIntervalsAtRisk;
 //@}
+vector<ThreadInfantStats> threadInfantStats;
 
 /// Non-malaria mortality in under 1year olds.
 /// Set by init ()
@@ -51,6 +53,10 @@ void initCMCommon( const OM::Parameters& parameters, SimTime hsMemory ){
     oddsRatioThreshold = exp( parameters[Parameters::LOG_ODDS_RATIO_CF_COMMUNITY] );
     infantDeaths.resize(sim::stepsPerYear());
     infantIntervalsAtRisk.resize(sim::stepsPerYear());
+    ThreadInfantStats zero;
+    zero.deaths.assign( sim::stepsPerYear(), 0 );
+    zero.intervalsAtRisk.assign( sim::stepsPerYear(), 0 );
+    threadInfantStats.assign( util::parallel::numThreads() - 1, zero );
     nonMalariaMortality=parameters[Parameters::NON_MALARIA_INFANT_MORTALITY];
 }
 
@@ -61,6 +67,18 @@ void mainSimInitCMCommon () {
     }
 }
 
+void mergeThreadInfantStats(){
+    for( size_t t = 0; t < threadInfantStats.size(); ++t ){
+        ThreadInfantStats& stats = threadInfantStats[t];
+        for( size_t i = 0; i < stats.deaths.size(); ++i ){
+            infantDeaths[i] += stats.deaths[i];
+            infantIntervalsAtRisk[i] += stats.intervalsAtRisk[i];
+        }
+        stats.deaths.assign( stats.deaths.size(), 0 );
+        stats.intervalsAtRisk.assign( stats.intervalsAtRisk.size(), 0 );
+    }
+}
+
 void staticCheckpointCMCommon (istream& stream) {
     infantDeaths & stream;
     infantIntervalsAtRisk & stream;
@@ -79,5 +79,18 @@ extern std::vector<int> infantDeaths;
 extern std::vector<int> infantIntervalsAtRisk;
 //@}
 
+/// Infant statistics of one thread (as infantDeaths, infantIntervalsAtRisk)
+struct ThreadInfantStats {
+    std::vector<int> deaths;
+    std::vector<int> intervalsAtRisk;
+};
+/** Statistics of threads 1, 2, ... during parallel updates (thread 0 uses
+ * infantDeaths and infantIntervalsAtRisk directly); zero after merging. */
+extern std::vector<ThreadInfantStats> threadInfantStats;
+
+/** Add infant statistics of threads other than the first into infantDeaths
+ * and infantIntervalsAtRisk. Call outside of parallel regions. */
+void mergeThreadInfantStats();
+
 } }
 #endif
@@ -29,6 +29,8 @@
 #include "util/ModelOptions.h"
 #include "util/CommandLine.h"
 #include "util/errors.h"
+#include "util/parallel.h"
+#include "util/profile.h"
 #include "schema/scenario.h"
 
 namespace OM { namespace Clinical {
@@ -121,6 +123,8 @@ bool ClinicalModel::isDead( SimTime age ){
 }
 
 void ClinicalModel::update (Human& human, double ageYears, bool newBorn) {
+    util::profile::Scope profileScope( util::profile::CLINICAL_UPDATE );
+    
     if (doomed < NOT_DOOMED)	// Countdown to indirect mortality
         doomed -= sim::oneTS().inDays();
     
@@ -146,11 +150,14 @@ void ClinicalModel::updateInfantDeaths( SimTime age ){
     // update array for the infant death rates
     if (age < sim::oneYear()){
         size_t index = age / sim::oneTS();
-        infantIntervalsAtRisk[index] += 1;     // baseline
+        const size_t thread = util::parallel::threadIndex();
+        vector<int>& atRisk = thread == 0 ? infantIntervalsAtRisk : threadInfantStats[thread-1].intervalsAtRisk;
+        vector<int>& deaths = thread == 0 ? infantDeaths : threadInfantStats[thread-1].deaths;
+        atRisk[index] += 1;     // baseline
         // Testing doomed == DOOMED_NEXT_TS gives very slightly different results than
         // testing doomed == DOOMED_INDIRECT (due to above if(..))
         if( doomed == DOOMED_COMPLICATED || doomed == DOOMED_NEXT_TS || doomed == DOOMED_NEONATAL ){
-            infantDeaths[index] += 1;  // deaths
+            deaths[index] += 1;  // deaths
         }
     }
 }
@@ -78,6 +78,13 @@ public:
      * @param newBorn True if human age is one time step old */
     void update (Human& human, double ageYears, bool newBorn);
     
+    /** True if no clinical event is pending (the human is not doomed). For
+     * such a human, not newborn and without parasites, update() only draws
+     * random numbers (given the conditions of Human::update()). */
+    inline bool isIdle() const{
+        return doomed == NOT_DOOMED;
+    }
+    
     /** For infants, updates the infantIntervalsAtRisk and potentially
      * infantDeaths arrays. */
     void updateInfantDeaths( SimTime age );
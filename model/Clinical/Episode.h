@@ -80,6 +80,7 @@ public:
             surveyPeriod(mon::NOT_USED),
             ageGroup(),
             cohortSet(0),
+            weight(1),
             state(NONE)
     {};
   ~Episode();
@@ -116,6 +117,8 @@ private:
     mon::AgeGroup ageGroup;
     /// Cohort membership
     uint32_t cohortSet;
+    /// Number of people the individual represents (see Human::weight())
+    uint32_t weight;
     /// Descriptor of state, containing reporting info. Not all information will
     /// be reported (e.g. indirect deaths are reported independantly).
     Episode::State state;
@@ -28,10 +28,13 @@
 #include "Transmission/TransmissionModel.h"
 #include "PopulationStats.h"
 #include "util/ModelOptions.h"
+#include "util/CommandLine.h"
 #include "util/vectors.h"
+#include "util/parallel.h"
 #include "util/StreamValidator.h"
 #include "Population.h"
 #include "interventions/InterventionManager.hpp"
+#include "interventions/SubPopIndex.h"
 #include "mon/reporting.h"
 #include "schema/scenario.h"
 
@@ -40,12 +43,22 @@ namespace OM { namespace Host {
     using interventions::ComponentId;
     
     bool opt_report_only_at_risk = false;
+    // Skip work for idle hosts (see Human::update())
+    bool opt_skip_idle = false;
 
 // -----  Static functions  -----
 
+vector<vector<double> > threadEIRPerGenotype;      // cache (one per thread)
+
 void Human::init( const Parameters& parameters, const scnXml::Scenario& scenario ){    // static
     HumanHet::init();
+    threadEIRPerGenotype.resize( util::parallel::numThreads() );
     opt_report_only_at_risk = util::ModelOptions::option( util::REPORT_ONLY_AT_RISK );
+    // Not with models whose clinical update may do more than draw random
+    // numbers for a host without parasites
+    opt_skip_idle = util::CommandLine::option( util::CommandLine::SKIP_IDLE_HOSTS ) &&
+        !util::ModelOptions::option( util::CLINICAL_EVENT_SCHEDULER ) &&
+        !util::ModelOptions::option( util::NON_MALARIA_FEVERS );
     
     const scnXml::Model& model = scenario.getModel();
     // Init models used by humans:
@@ -62,8 +75,11 @@ void Human::init( const Parameters& parameters, const scnXml::Scenario& scenario
 Human::Human(Transmission::TransmissionModel& tm, SimTime dateOfBirth) :
     infIncidence(InfectionIncidenceModel::createModel()),
     m_DOB(dateOfBirth),
+    m_id(0),
     m_cohortSet(0),
-    nextCtsDist(0)
+    nextCtsDist(0),
+    m_weight(util::CommandLine::getHumanWeight()),
+    m_subPopFirstExp(sim::future())
 {
   // Initial humans are created at time 0 and may have DOB in past. Otherwise DOB must be now.
   assert( m_DOB == sim::nowOrTs1() || (sim::now() == sim::zero() && m_DOB < sim::now()) );
@@ -79,8 +95,11 @@ Human::Human(SimTime dateOfBirth) :
     infIncidence(0),
     clinicalModel(0),
     m_DOB(dateOfBirth),
+    m_id(0),
     m_cohortSet(0),
-    nextCtsDist(0)
+    nextCtsDist(0),
+    m_weight(util::CommandLine::getHumanWeight()),
+    m_subPopFirstExp(sim::future())
 {}
 
 void Human::destroy() {
@@ -92,13 +111,9 @@ void Human::destroy() {
 
 // -----  Non-static functions: per-time-step update  -----
 
-vector<double> EIR_per_genotype;        // cache (not thread safe)
-
 bool Human::update(Transmission::TransmissionModel* transmissionModel, bool doUpdate) {
 #ifdef WITHOUT_BOINC
-    ++PopulationStats::humanUpdateCalls;
-    if( doUpdate )
-        ++PopulationStats::humanUpdates;
+    PopulationStats::addHumanUpdate( doUpdate, doUpdate && withinHostModel->isIdle() );
 #endif
     // For integer age checks we use age0 to e.g. get 73 steps comparing less than 1 year old
     SimTime age0 = age(sim::ts0());
@@ -114,39 +129,67 @@ bool Human::update(Transmission::TransmissionModel* transmissionModel, bool doUp
         double ageYears1 = age(sim::ts1()).inYears();
         // monitoringAgeGroup is the group for the start of the time step.
         monitoringAgeGroup.update( age0 );
-        // check sub-pop expiry
-        for( map<ComponentId,SimTime>::iterator expIt =
-            m_subPopExp.begin(), expEnd = m_subPopExp.end(); expIt != expEnd; )
-        {
-            if( !(expIt->second >= sim::ts0()) ){       // membership expired
-                // don't flush reports
-                // report removal due to expiry
-                mon::reportMHI( mon::MHR_SUB_POP_REM_TOO_OLD, *this, 1 );
-                m_cohortSet = mon::updateCohortSet( m_cohortSet, expIt->first, false );
-                // erase element, but continue iteration (note: this is simpler in C++11)
-                map<ComponentId,SimTime>::iterator toErase = expIt;
-                ++expIt;
-                m_subPopExp.erase( toErase );
-            }else{
-                ++expIt;
-            }
-        }
+        // check sub-pop expiry (only when some membership may have expired)
+        if( m_subPopFirstExp < sim::ts0() )
+            removeExpiredSubPops();
+        vector<double>& EIR_per_genotype = threadEIRPerGenotype[util::parallel::threadIndex()];
         // ageYears1 used only in PerHost::relativeAvailabilityAge(); difference to age0 should be minor
         double EIR = transmissionModel->getEIR( *this, age0, ageYears1,
                 EIR_per_genotype );
-        int nNewInfs = infIncidence->numNewInfections( *this, EIR );
+        // An idle host has no parasites, drugs or pending clinical events.
+        // With opt_skip_idle, incidence is skipped without exposure, and the
+        // clinical update of an idle host without new infections (both would
+        // only draw random numbers). The within-host update still decays
+        // immunity; the pathogenesis model catches up on its decay when next
+        // used.
+        const bool idle = opt_skip_idle && age0 != sim::zero() &&
+            clinicalModel->isIdle() && withinHostModel->isIdle();
+        int nNewInfs = (opt_skip_idle && EIR == 0.0) ? 0 :
+            infIncidence->numNewInfections( *this, EIR );
         
         // ageYears1 used when medicating drugs (small effect) and in immunity model (which was parameterised for it)
         withinHostModel->update(nNewInfs, EIR_per_genotype, ageYears1,
                 _vaccine.getFactor(interventions::Vaccine::BSV));
         
         // ageYears1 used to get case fatality and sequelae probabilities, determine pathogenesis
-        clinicalModel->update( *this, ageYears1, age0 == sim::zero() );
+        if( !idle || nNewInfs > 0 )
+            clinicalModel->update( *this, ageYears1, age0 == sim::zero() );
         clinicalModel->updateInfantDeaths( age0 );
     }
     return false;
 }
 
+void Human::removeExpiredSubPops(){
+    m_subPopFirstExp = sim::future();
+    for( map<ComponentId,SimTime>::iterator expIt =
+        m_subPopExp.begin(), expEnd = m_subPopExp.end(); expIt != expEnd; )
+    {
+        if( !(expIt->second >= sim::ts0()) ){       // membership expired
+            // don't flush reports
+            // report removal due to expiry
+            mon::reportMHI( mon::MHR_SUB_POP_REM_TOO_OLD, *this, 1 );
+            m_cohortSet = mon::updateCohortSet( m_cohortSet, expIt->first, false );
+            // erase element, but continue iteration (note: this is simpler in C++11)
+            map<ComponentId,SimTime>::iterator toErase = expIt;
+            ++expIt;
+            m_subPopExp.erase( toErase );
+        }else{
+            m_subPopFirstExp = min( m_subPopFirstExp, expIt->second );
+            ++expIt;
+        }
+    }
+}
+
+void Human::checkpointSubPops( ostream& stream ){
+    m_subPopExp & stream;
+}
+void Human::checkpointSubPops( istream& stream ){
+    m_subPopExp & stream;
+    m_subPopFirstExp = sim::future();
+    for( SubPopT::const_iterator it = m_subPopExp.begin(); it != m_subPopExp.end(); ++it )
+        m_subPopFirstExp = min( m_subPopFirstExp, it->second );
+}
+
 void Human::addInfection(){
     withinHostModel->importInfection();
 }
@@ -177,8 +220,12 @@ void Human::summarize() {
 
 void Human::reportDeployment( ComponentId id, SimTime duration ){
     if( duration <= sim::zero() ) return; // nothing to do
-    m_subPopExp[id] = sim::nowOrTs1() + duration;
+    const SimTime expiry = sim::nowOrTs1() + duration;
+    m_subPopExp[id] = expiry;
+    m_subPopFirstExp = min( m_subPopFirstExp, expiry );
     m_cohortSet = mon::updateCohortSet( m_cohortSet, id, true );
+    if( interventions::SubPopIndex::isTracked( id ) )
+        interventions::SubPopIndex::add( id, m_id );
 }
 void Human::removeFirstEvent( interventions::SubPopRemove::RemoveAtCode code ){
     const vector<ComponentId>& removeAtList = interventions::removeAtIds[code];
@@ -29,6 +29,7 @@
 #include <map>
 
 class UnittestUtil;
+class SubPopIndexSuite;
 namespace scnXml {
     class Scenario;
 }
@@ -83,7 +84,9 @@ public:
       monitoringAgeGroup & stream;
       m_cohortSet & stream;
       nextCtsDist & stream;
-      m_subPopExp & stream;
+      checkpointSubPops( stream );
+      // m_weight is not checkpointed: it is the same for all humans, and the
+      // "static" section checks it against --human-weight
   }
   //@}
   
@@ -119,6 +122,8 @@ public:
     inline SimTime age( SimTime time )const{ return time - m_DOB; }
     /** Date of birth. */
     inline SimTime getDateOfBirth() const{ return m_DOB; }
+    /** Identifier, unique within a run (set by the Population). */
+    inline uint32_t id() const{ return m_id; }
   
   /** Return true if human is a member of the sub-population.
    * 
@@ -130,6 +135,10 @@ public:
   }
   /** Return the cohort set. */
   inline uint32_t cohortSet()const{ return m_cohortSet; }
+  /** Number of (identical) people this human represents. Counts reported
+   * to monitoring and population sums used by transmission are scaled by
+   * this. */
+  inline uint32_t weight()const{ return m_weight; }
   
   /// Return the index of next continuous intervention to be deployed
   inline uint32_t getNextCtsDist()const{ return nextCtsDist; }
@@ -163,6 +172,14 @@ public:
       return monitoringAgeGroup;
   }
   
+  /** Re-derive the monitoring age group, as at the last update. Used when
+   * age groups are not those the current group was found with (after
+   * loading a warm-up snapshot). */
+  inline void resetMonitoringAgeGroup() {
+      monitoringAgeGroup = mon::AgeGroup();
+      monitoringAgeGroup.update( age(sim::now() - sim::oneTS()) );
+  }
+  
   inline interventions::PerHumanVaccine& getVaccine(){ return _vaccine; }
   inline const interventions::PerHumanVaccine& getVaccine() const{ return _vaccine; }
   
@@ -190,6 +207,13 @@ private:
   /// Hacky constructor for use in testing. Test code must do further initialisation as necessary.
   Human(SimTime dateOfBirth);
   
+  /// Remove memberships of sub-populations which expired (during update)
+  void removeExpiredSubPops();
+  
+  /// Checkpoint m_subPopExp; reading also sets m_subPopFirstExp
+  void checkpointSubPops( ostream& stream );
+  void checkpointSubPops( istream& stream );      ///< ditto
+  
   /// The InfectionIncidenceModel translates per-host EIR into new infections
   InfectionIncidenceModel *infIncidence;
   
@@ -201,6 +225,9 @@ private:
   
   SimTime m_DOB;        // date of birth; humans are always born at the end of a time step
   
+  /// Identifier (see id()); not checkpointed here but by the Population
+  uint32_t m_id;
+  
   /// Vaccines
   interventions::PerHumanVaccine _vaccine;
   
@@ -215,8 +242,11 @@ private:
   /// The next continuous distribution in the series
   uint32_t nextCtsDist;
   
-  //TODO(optimisation): it might be better to instead store for each
-  // ComponentId of interest the set of humans who are members
+  /// Number of people represented (see weight())
+  uint32_t m_weight;
+  
+  // Members of sub-populations used to restrict timed deployments are also
+  // listed by interventions::SubPopIndex.
   typedef std::map<interventions::ComponentId,SimTime> SubPopT;
   /** This lists sub-populations of which the human is a member together with
    * expiry time.
@@ -230,8 +260,13 @@ private:
    * mean 1 intervention deployment (that where the human becomes a member) and
    * 1 human update (the next). */
   SubPopT m_subPopExp;
+  /** No element of m_subPopExp expires before this time, thus update() only
+   * needs to look for expired memberships once this has passed. */
+  SimTime m_subPopFirstExp;
   
   friend class ::UnittestUtil;
+  friend class ::SubPopIndexSuite;
+  friend class ::OM::Population;       // sets m_id
 };
 
 } }
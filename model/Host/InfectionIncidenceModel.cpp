@@ -26,6 +26,7 @@
 #include "Monitoring/Continuous.h"
 #include "util/ModelOptions.h"
 #include "util/random.h"
+#include "util/parallel.h"
 #include "util/errors.h"
 
 #include <stdexcept>
@@ -64,6 +65,7 @@ bool opt_neg_bin_mass_action = false, opt_lognormal_mass_action = false,
 
 // ———  variables  ———
 int InfectionIncidenceModel::ctsNewInfections = 0;
+vector<InfectionIncidenceModel::ThreadCount> InfectionIncidenceModel::threadCounts;
 
 // -----  static initialisation  -----
 
@@ -120,11 +122,19 @@ void InfectionIncidenceModel::init ( const Parameters& parameters ) {
     }
     
     Monitoring::Continuous.registerCallback( "new infections", "\tnew infections", &InfectionIncidenceModel::ctsReportNewInfections );
+    threadCounts.assign( util::parallel::numThreads() - 1, ThreadCount() );
 }
 
 
 // -----  other static methods  -----
 
+void InfectionIncidenceModel::mergeThreads(){
+    for( size_t t = 0; t < threadCounts.size(); ++t ){
+        ctsNewInfections += threadCounts[t].newInfections;
+        threadCounts[t].newInfections = 0;
+    }
+}
+
 void InfectionIncidenceModel::ctsReportNewInfections (ostream& stream){
     stream << '\t' << ctsNewInfections;
     ctsNewInfections = 0;
@@ -241,7 +251,9 @@ int InfectionIncidenceModel::numNewInfections (const Human& human, double effect
         n = WithinHost::WHInterface::MAX_INFECTIONS;
     }
     mon::reportMHI( mon::MHR_NEW_INFECTIONS, human, n );
-    ctsNewInfections += n;
+    const size_t thread = util::parallel::threadIndex();
+    if( thread == 0 ) ctsNewInfections += n;
+    else threadCounts[thread-1].newInfections += n;
     return n;
   }
   if ( (boost::math::isnan)(expectedNumInfections) ){	// check for not-a-number
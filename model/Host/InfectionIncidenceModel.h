@@ -56,6 +56,10 @@ public:
   }
   //@}
   
+  /** Add new infections counted by threads other than the first into
+   * ctsNewInfections. Call outside of parallel regions. */
+  static void mergeThreads();
+  
   /// Checkpointing
   template<class S>
   void operator& (S& stream) {
@@ -118,6 +122,16 @@ protected:
   
     /// Number of new infections introduced, per continuous reporting period
     static int ctsNewInfections;
+    
+    /// Count of one thread. Padded so that threads don't share cache lines.
+    struct ThreadCount {
+        ThreadCount() : newInfections(0) {}
+        int newInfections;
+        char padding[64];
+    };
+    /// Counts of threads 1, 2, ... during parallel updates (thread 0 uses
+    /// ctsNewInfections directly); zero after merging
+    static vector<ThreadCount> threadCounts;
 };
 
 //TODO(optimisation): none of these add data members, so should we be using
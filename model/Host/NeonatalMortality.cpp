@@ -95,19 +95,13 @@ void NeonatalMortality::update (const Population& population) {
     int nCounter=0;	// total number
     int pCounter=0;	// number with patent infections, needed for prev in 20-25y
     
-    for (Population::ConstIter iter = population.cbegin(); iter != population.cend(); ++iter){
-        // diagnosticDefault() gives patency after the last time step's
-        // update, so it's appropriate to use age at the beginning of this step.
-        SimTime age = iter->age(sim::ts0());
-        
-        // Note: since we're using a linked list, we have to iterate until we reach
-        // the individuals we're interested in. Due to population structure, it's
-        // probably quickest to start iterating from the oldest.
-        if( age >= ageUb ) continue;
-        if( age < ageLb ) break;	// Not interested in younger individuals.
-        
+    // diagnosticDefault() gives patency after the last time step's
+    // update, so it's appropriate to use age at the beginning of this step.
+    size_t first, last;
+    population.ageRange( sim::ts0(), ageLb, ageUb, first, last );
+    for( size_t i = first; i < last; ++i ){
         nCounter ++;
-        if( iter->withinHostModel->diagnosticResult(*neonatalDiagnostic) ){
+        if( population.human(i).withinHostModel->diagnosticResult(*neonatalDiagnostic) ){
             pCounter ++;
         }
     }
@@ -48,9 +48,7 @@ LSTMDrug::LSTMDrug(const LSTMDrugType& type) :
 
 void LSTMDrug::medicate (double time, double qty, double bodyMass) {
     double conc = qty / (typeData.getVolumeOfDistribution() * bodyMass);        // mg / l
-    // multimap insertion: is ordered
-    DoseMap::iterator lastInserted =
-    doses.insert (doses.end(), make_pair (time, DoseParams( conc, 0 )));
+    size_t lastInserted = insertDose( time, DoseParams( conc, 0 ) );
     check_split_IV( lastInserted );
 }
 
@@ -58,38 +56,59 @@ void LSTMDrug::medicateIV (double time, double duration, double qty ) {
     assert( duration > 0.0 );
     
     double infusRate = qty / duration;	// mg/day
-    DoseMap::iterator lastInserted =
-    doses.insert(doses.end(), make_pair( time, DoseParams( infusRate, duration ) ) );    
+    size_t lastInserted = insertDose( time, DoseParams( infusRate, duration ) );
     check_split_IV( lastInserted );
     
-    doses.insert( doses.end(), make_pair( time+duration, DoseParams() ) );
+    insertDose( time+duration, DoseParams() );
 }
 
-void LSTMDrug::check_split_IV( DoseMap::iterator lastInserted ){
-    for( DoseMap::iterator it = doses.begin(); it != doses.end(); ++it ){
-        if( it == lastInserted )
+struct DoseTimeLess {
+    bool operator() (double time, const pair<double,DoseParams>& dose) const{
+        return time < dose.first;
+    }
+};
+
+size_t LSTMDrug::insertDose( double time, const DoseParams& dose ){
+    DoseList::iterator pos = upper_bound( doses.begin(), doses.end(), time, DoseTimeLess() );
+    return doses.insert( pos, make_pair( time, dose ) ) - doses.begin();
+}
+
+void LSTMDrug::addDayBoundaries(){
+    if( doses.empty() || doses.front().first != 0.0 ){
+        doses.insert( doses.begin(), make_pair( 0.0, DoseParams() ) );
+    }
+    DoseList::iterator pos = upper_bound( doses.begin(), doses.end(), 1.0, DoseTimeLess() );
+    if( pos == doses.begin() || (pos-1)->first != 1.0 ){
+        doses.insert( pos, make_pair( 1.0, DoseParams() ) );
+    }
+}
+
+void LSTMDrug::check_split_IV( size_t lastInserted ){
+    for( size_t i = 0; i < doses.size(); ++i ){
+        if( i == lastInserted )
             continue;
+        pair<double,DoseParams>& it = doses[i], &last = doses[lastInserted];
         
-        if( it->first == lastInserted->first ){
-            if( it->second.duration == 0.0 && lastInserted->second.duration == 0.0 ){
-                it->second.qty += lastInserted->second.qty;
-                doses.erase( lastInserted );
+        if( it.first == last.first ){
+            if( it.second.duration == 0.0 && last.second.duration == 0.0 ){
+                it.second.qty += last.second.qty;
+                doses.erase( doses.begin() + lastInserted );
                 return;
-            } else if( it->second.duration == 0.0 ){
+            } else if( it.second.duration == 0.0 ){
                 // oral followed by IV; no problem
-            } else if( lastInserted->second.duration == 0.0 ){
+            } else if( last.second.duration == 0.0 ){
                 // IV followed by oral; needs to be analysed in other order
-                swap( it->second, lastInserted->second );
+                swap( it.second, last.second );
             } else {
                 throw util::xml_scenario_error( "IV,IV medications overlap — not supported!" );
             }
-        } else if( it->first < lastInserted->first ){
-            if( it->first + it->second.duration > lastInserted->first ){
+        } else if( it.first < last.first ){
+            if( it.first + it.second.duration > last.first ){
                 // TODO: if one is an oral dose, could split IV
                 throw util::xml_scenario_error( "IV/oral medications overlap — not supported!" );
             }
-        } else if( it->first > lastInserted->first ){
-            if( lastInserted->first + lastInserted->second.duration > it->first ){
+        } else if( it.first > last.first ){
+            if( last.first + last.second.duration > it.first ){
                 // TODO: if one is an oral dose, could split IV
                 throw util::xml_scenario_error( "IV/oral medications overlap — not supported!" );
             }
@@ -98,10 +117,11 @@ void LSTMDrug::check_split_IV( DoseMap::iterator lastInserted ){
     
     // Make sure one dose is evaluated separately on each day
     double dayEnd = 1.0;
-    while( lastInserted->first + lastInserted->second.duration > dayEnd ){
-        double remaining_duration = lastInserted->first + lastInserted->second.duration - dayEnd;
-        lastInserted->second.duration = dayEnd - lastInserted->first;
-        lastInserted = doses.insert( doses.end(), make_pair( dayEnd, DoseParams( lastInserted->second.qty, remaining_duration ) ) );
+    while( doses[lastInserted].first + doses[lastInserted].second.duration > dayEnd ){
+        DoseParams& dose = doses[lastInserted].second;
+        double remaining_duration = doses[lastInserted].first + dose.duration - dayEnd;
+        dose.duration = dayEnd - doses[lastInserted].first;
+        lastInserted = insertDose( dayEnd, DoseParams( dose.qty, remaining_duration ) );
         dayEnd += 1.0;
     }
 }
@@ -122,16 +142,10 @@ double LSTMDrug::calculateDrugFactor(uint32_t genotype) {
     
     // Make sure we have a dose at both time 0 and time 1
     //NOTE: this forces function to be non-const and not thread-safe over the same human (probably not an issue)
-    //TODO(performance): can we use a faster allocator? Or avoid allocating at all?
-    if( doses.begin()->first != 0.0 ){
-        doses.insert( doses.begin(), make_pair( 0.0, DoseParams() ) );
-    }
-    if( doses.count( 1.0 ) == 0 ){
-        doses.insert( make_pair( 1.0, DoseParams() ) );
-    }
+    addDayBoundaries();
     
-    DoseMap::const_iterator dose = doses.begin();
-    DoseMap::const_iterator next_dose = dose;
+    DoseList::const_iterator dose = doses.begin();
+    DoseList::const_iterator next_dose = dose;
     ++next_dose;
     while (next_dose!=doses.end()) {
         double time_to_next = next_dose->first - dose->first;
@@ -158,16 +172,10 @@ double LSTMDrug::calculateDrugFactor(uint32_t genotype) {
 
 bool LSTMDrug::updateConcentration () {
     // Make sure we have a dose at both time 0 and time 1
-    //TODO(performance): can we use a faster allocator? Or avoid allocating at all?
-    if( doses.begin()->first != 0.0 ){
-        doses.insert( doses.begin(), make_pair( 0.0, DoseParams() ) );
-    }
-    if( doses.count( 1.0 ) == 0 ){
-        doses.insert( make_pair( 1.0, DoseParams() ) );
-    }
+    addDayBoundaries();
     
-    DoseMap::const_iterator dose = doses.begin();
-    DoseMap::const_iterator next_dose = dose;
+    DoseList::const_iterator dose = doses.begin();
+    DoseList::const_iterator next_dose = dose;
     ++next_dose;
     while (next_dose!=doses.end()) {
         double time_to_next = next_dose->first - dose->first;
@@ -189,18 +197,16 @@ bool LSTMDrug::updateConcentration () {
     }
     
     // Clear today's dose list — they've been added to concentration now.
-    DoseMap::iterator firstTomorrow = doses.lower_bound( 1.0 );
-    doses.erase( doses.begin(), firstTomorrow );
+    size_t firstTomorrow = 0;
+    while( firstTomorrow < doses.size() && doses[firstTomorrow].first < 1.0 )
+        ++firstTomorrow;
+    doses.erase( doses.begin(), doses.begin() + firstTomorrow );
     
-    //TODO(performance): is there some way we can avoid copying here? Cache all possible simulated days?
-    // Now we've removed today's doses, subtract a day from times of tomorrow's doses.
-    // Keys are read-only, so we have to create a copy.
-    DoseMap newDoses;
-    for (DoseMap::const_iterator dose = doses.begin(); dose!=doses.end(); ++dose) {
-        // tomorrow's dose; decrease time counter by a day
-        newDoses.insert( make_pair( dose->first - 1.0, dose->second ) );
+    // Now we've removed today's doses, subtract a day from times of tomorrow's
+    // doses (this doesn't change their order).
+    for( DoseList::iterator dose = doses.begin(); dose != doses.end(); ++dose ){
+        dose->first -= 1.0;
     }
-    doses.swap( newDoses );	// assign it modified doses (swap may be faster than assign)
     
     util::streamValidate( concentration );
     
@@ -212,27 +218,26 @@ bool LSTMDrug::updateConcentration () {
 
 namespace util { namespace checkpoint {
     
-void operator& (multimap<double,PkPd::DoseParams> x, ostream& stream) {
+// Same format as previously used for multimap<double,DoseParams>
+void operator& (const vector<pair<double,PkPd::DoseParams> >& x, ostream& stream) {
     x.size() & stream;
-    for (multimap<double,PkPd::DoseParams>::iterator pos = x.begin (); pos != x.end() ; ++pos) {
+    for (vector<pair<double,PkPd::DoseParams> >::const_iterator pos = x.begin (); pos != x.end() ; ++pos) {
         pos->first & stream;
-        pos->second & stream;
+        PkPd::DoseParams t = pos->second;
+        t & stream;
     }
 }
-void operator& (multimap<double,PkPd::DoseParams>& x, istream& stream) {
+void operator& (vector<pair<double,PkPd::DoseParams> >& x, istream& stream) {
     size_t l;
     l & stream;
     validateListSize (l);
-    x.clear ();
-    multimap<double,PkPd::DoseParams>::iterator pos = x.begin ();
+    x.resize (l);
     for (size_t i = 0; i < l; ++i) {
-        double s;
-        PkPd::DoseParams t;
-        s & stream;
-        t & stream;
-        pos = x.insert (pos, make_pair (s,t));
+        x[i].first & stream;
+        x[i].second & stream;
+        if( i > 0 && x[i].first < x[i-1].first )
+            throw checkpoint_error( "LSTMDrug: doses not ordered" );
     }
-    assert( x.size() == l );
 }
 
 } }
@@ -33,8 +33,8 @@ struct DoseParams;
 }
 namespace util {
 namespace checkpoint {
-void operator& (multimap<double,PkPd::DoseParams> x, ostream& stream);
-void operator& (multimap<double,PkPd::DoseParams>& x, istream& stream);
+void operator& (const vector<pair<double,PkPd::DoseParams> >& x, ostream& stream);
+void operator& (vector<pair<double,PkPd::DoseParams> >& x, istream& stream);
 }
 }
 
@@ -122,14 +122,24 @@ public:
     }
 
 protected:
-    typedef multimap<double,DoseParams> DoseMap;
+    /** Sorted list of (time, dose) pairs. Doses with equal times are kept in
+     * order of insertion (as in a multimap). */
+    typedef vector<pair<double,DoseParams> > DoseList;
+    
+    /** Insert a dose after all doses with time less than or equal to time,
+     * returning its index. */
+    size_t insertDose( double time, const DoseParams& dose );
+    
+    /** Make sure there are doses at times 0 and 1 (inserting doses with
+     * quantity zero as necessary). */
+    void addDayBoundaries();
 
     /** Check whether an IV dose needs to be split into multiple doses
      * (over two days or when an oral dose occurs in the middle).
      * If necessary, split.
      *
-     * Only check against lastInserted. */
-    void check_split_IV( DoseMap::iterator lastInserted );
+     * Only check against the dose with index lastInserted. */
+    void check_split_IV( size_t lastInserted );
 
     /// Always links a drug instance to its drug-type data
     const LSTMDrugType& typeData;
@@ -141,8 +151,11 @@ protected:
      * First parameter (key) is time in days, second describes dose.
      *
      * Used in calculateDrugFactor temporarily,
-     * and in updateConcentration() to update concentration. */
-    DoseMap doses;
+     * and in updateConcentration() to update concentration.
+     * 
+     * Doses are inserted, removed and moved to the next day in place, so
+     * once the list has grown to its usual size no memory is allocated. */
+    DoseList doses;
 };
 
 }
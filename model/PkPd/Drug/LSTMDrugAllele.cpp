@@ -21,6 +21,7 @@
 // Declaration in LSTMDrugType.h due to circular dependency:
 #include "PkPd/Drug/LSTMDrugType.h"
 #include "util/errors.h"
+#include "util/parallel.h"
 #include "schema/pharmacology.h"
 
 #include <cmath>
@@ -44,7 +45,9 @@ LSTMDrugPD::Cache::Cache( double c, double d, double r ) :
     hash = hasher(c) ^ hasher(d) ^ hasher(r);
 }
 
-LSTMDrugPD::LSTMDrugPD( const scnXml::Phenotype& phenotype, double elimination_rate_constant ){
+LSTMDrugPD::LSTMDrugPD( const scnXml::Phenotype& phenotype, double elimination_rate_constant ) :
+        cachedIV( util::parallel::numThreads() )
+{
     slope = phenotype.getSlope ();
     power = phenotype.getMax_killing_rate () / (elimination_rate_constant * slope);
     IC50_pow_slope = pow(phenotype.getIC50 (), slope);
@@ -94,8 +97,10 @@ double func_IV_conc( double t, void* pp ){
 
 double LSTMDrugPD::calcFactorIV( const LSTMDrugType& drug, double& C0, double duration, double rate ) const{
     Cache key( C0, duration, rate );
-    CachedIV::const_iterator it = cachedIV.find( key );
-    if( it != cachedIV.end() ){
+    // Humans may be updated concurrently, so each thread uses its own cache
+    CachedIV& cache = cachedIV[util::parallel::threadIndex()];
+    CachedIV::const_iterator it = cache.find( key );
+    if( it != cache.end() ){
         // cached result: use it
         C0 = it->C1;
         return it->drugFactor;
@@ -142,7 +147,7 @@ double LSTMDrugPD::calcFactorIV( const LSTMDrugType& drug, double& C0, double du
         // use key as our new cache
         key.C1 = C0;
         key.drugFactor = 1.0 / exp( intfC );
-        bool inserted = cachedIV.insert( key ).second;
+        bool inserted = cache.insert( key ).second;
         if (inserted != true) assert( false );  // avoid unused variable warning
         
         return key.drugFactor;
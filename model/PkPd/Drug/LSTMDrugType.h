@@ -71,7 +71,8 @@ class LSTMDrugPD {
     };
 
     typedef boost::unordered_set<Cache,Cache_hash> CachedIV;
-    mutable CachedIV cachedIV;
+    // One cache per thread (see util::parallel), indexed by thread index
+    mutable vector<CachedIV> cachedIV;
     
     /// Slope of the dose response curve (no unit)
     double slope;
@@ -24,6 +24,7 @@
 #include "mon/reporting.h"
 #include "util/checkpoint_containers.h"
 #include "util/errors.h"
+#include "util/profile.h"
 
 #include "schema/scenario.h"
 
@@ -78,6 +79,7 @@ void LSTMModel::prescribe(size_t schedule, size_t dosage, double age, double bod
 
 void LSTMModel::medicate(double body_mass){
     if( medicateQueue.empty() ) return;
+    util::profile::Scope profileScope( util::profile::PKPD );
     
     // Process pending medications (in interal queue) and apply/update:
     list<MedicateData>::iterator it = medicateQueue.begin();
@@ -94,6 +96,7 @@ void LSTMModel::medicate(double body_mass){
 }
 
 void LSTMModel::medicateDrug(size_t typeIndex, double qty, double time, double duration, double bodyMass) {
+    factorCache.clear();
     list<LSTMDrug>::iterator drug = m_drugs.begin();
     while (drug != m_drugs.end()) {
         if (drug->getIndex() == typeIndex)
@@ -105,6 +108,7 @@ void LSTMModel::medicateDrug(size_t typeIndex, double qty, double time, double d
     drug = m_drugs.begin();	// the drug we just added
     
     medicateGotDrug:
+    util::profile::count( util::profile::DRUG_DOSES );
     if( duration > 0.0 ){
         drug->medicateIV (time, duration, qty);
     }else{      // 0 or NaN
@@ -113,12 +117,19 @@ void LSTMModel::medicateDrug(size_t typeIndex, double qty, double time, double d
 }
 
 double LSTMModel::getDrugFactor (uint32_t genotype) {
-    double factor = 1.0; //no effect
+    if( m_drugs.empty() ) return 1.0;   // no effect
+    
+    // Usually there are very few genotypes, so a linear search is fastest
+    for( size_t i = 0; i < factorCache.size(); ++i ){
+        if( factorCache[i].first == genotype ) return factorCache[i].second;
+    }
     
+    double factor = 1.0; //no effect
     foreach( LSTMDrug& drug, m_drugs ){
         double drugFactor = drug.calculateDrugFactor(genotype);
         factor *= drugFactor;
     }
+    factorCache.push_back( make_pair( genotype, factor ) );
     return factor;
 }
 
@@ -130,6 +141,8 @@ public:
     }
 };
 void LSTMModel::decayDrugs () {
+    util::profile::Scope profileScope( util::profile::PKPD );
+    factorCache.clear();
     // for each item in m_drugs, remove if DecayPredicate::operator() returns true (so calls decay()):
     m_drugs.remove_if (DecayPredicate());
 }
@@ -117,7 +117,11 @@ public:
      *
      * Each time step, on each infection, the parasite density is multiplied by
      * the return value of this infection. The WithinHostModels are responsible
-     * for clearing infections once the parasite density is negligible. */
+     * for clearing infections once the parasite density is negligible.
+     * 
+     * The factor only depends on the genotype and drugs in the body, so it is
+     * calculated once per genotype per day (until medication or decayDrugs()
+     * changes the drugs). */
     double getDrugFactor (uint32_t genotype);
     
     /** After any resident infections have been reduced by getDrugFactor(),
@@ -126,6 +130,11 @@ public:
      * become negligible. */
     void decayDrugs ();
     
+    /// True when there are no drugs in the body and no pending medications
+    inline bool isIdle() const{
+        return m_drugs.empty() && medicateQueue.empty();
+    }
+    
     /** Make summaries of drug concentration data. */
     void summarize( const Host::Human& human ) const;
     
@@ -157,6 +166,11 @@ private:
     /// All pending medications
     list<MedicateData> medicateQueue;
     
+    /** Drug factors calculated today, as (genotype, factor) pairs. Cleared
+     * whenever drugs change; not checkpointed since it is always empty
+     * between updates. */
+    vector<pair<uint32_t,double> > factorCache;
+    
     friend class ::UnittestUtil;
 };
 
@@ -19,25 +19,33 @@
  */
 
 #include "Population.h"
+#include "PopulationStats.h"
 #include "Monitoring/Continuous.h"
 
 #include "Transmission/TransmissionModel.h"
 
 #include "Host/Human.h"
 #include "Host/NeonatalMortality.h"
+#include "Host/InfectionIncidenceModel.h"
 #include "WithinHost/WHInterface.h"
 #include "WithinHost/Genotypes.h"
 #include "WithinHost/Diagnostic.h"
 #include "Clinical/ClinicalModel.h"
 #include "Clinical/CaseManagementCommon.h"
+#include "interventions/SubPopIndex.h"
 
 #include "util/errors.h"
 #include "util/random.h"
 #include "util/ModelOptions.h"
 #include "util/StreamValidator.h"
+#include "util/CommandLine.h"
+#include "util/parallel.h"
+#include "util/profile.h"
+#include "mon/management.h"
 #include <schema/scenario.h>
 
 #include <cmath>
+#include <algorithm>
 #include <boost/format.hpp>
 #include <boost/assign.hpp>
 
@@ -75,7 +83,7 @@ void Population::staticCheckpoint (ostream& stream)
 // -----  non-static methods: creation/destruction, checkpointing  -----
 
 Population::Population(const scnXml::Entomology& entoData, size_t populationSize)
-    : populationSize (populationSize), recentBirths(0)
+    : populationSize (populationSize), recentBirths(0), nextHumanId(0)
 {
     using Monitoring::Continuous;
     Continuous.registerCallback( "hosts", "\thosts", MakeDelegate( this, &Population::ctsHosts ) );
@@ -115,6 +123,10 @@ Population::Population(const scnXml::Entomology& entoData, size_t populationSize
     _transmissionModel = Transmission::TransmissionModel::createTransmissionModel(entoData, populationSize);
 }
 
+Population::Population()
+    : populationSize (0), recentBirths(0), nextHumanId(0), _transmissionModel(0)
+{}
+
 Population::~Population()
 {
     for (Iter iter = population.begin(); iter != population.end(); ++iter) {
@@ -130,19 +142,28 @@ void Population::checkpoint (istream& stream)
     if (popSize > size_t (populationSize))
         throw util::checkpoint_error(
             (boost::format("pop size (%1%) exceeds that given in scenario.xml") %popSize).str() );
+    util::checkpoint::readArray( m_id, popSize, stream );
+    population.reserve( popSize );
+    m_dob.reserve( popSize );
     for (size_t i = 0; i < popSize && !stream.eof(); ++i) {
         // Note: calling this constructor of Host::Human is slightly wasteful, but avoids the need for another
         // ctor and leaves less opportunity for uninitialized memory.
-        population.push_back( new Host::Human (*_transmissionModel, sim::zero()) );
-        population.back() & stream;
+        Host::Human* h = new Host::Human (*_transmissionModel, sim::zero());
+        population.push_back( h );
+        (*h) & stream;
+        h->m_id = m_id[i];
+        m_dob.push_back( h->getDateOfBirth() );
+        indexLastBirth();
     }
     if (population.size() != popSize)
         throw util::checkpoint_error(
             (boost::format("Population: out of data (read %1% humans)") %population.size() ).str() );
+    interventions::SubPopIndex::rebuild( *this );
 }
 void Population::checkpoint (ostream& stream)
 {
     population.size() & stream;
+    util::checkpoint::writeArray( m_id, stream );
     for (Iter iter = population.begin(); iter != population.end(); ++iter)
         (*iter) & stream;
 }
@@ -162,6 +183,8 @@ void Population::createInitialHumans ()
     structure in any case). However, we don't update humans known not to survive
     until vector init, which saves computation and memory (no infections). */
     
+    // Counts are of people represented (see Human::weight()).
+    const int weight = util::CommandLine::getHumanWeight();
     int cumulativePop = 0;
     for (size_t iage_prev = AgeStructure::getMaxTStepsPerLife(), iage = iage_prev - 1;
          iage_prev > 0; iage_prev = iage, iage -= 1 )
@@ -169,7 +192,7 @@ void Population::createInitialHumans ()
         int targetPop = AgeStructure::targetCumPop( iage, populationSize );
         while (cumulativePop < targetPop) {
             newHuman( sim::zero() - sim::fromTS(iage) );
-            ++cumulativePop;
+            cumulativePop += weight;
         }
     }
     
@@ -184,11 +207,103 @@ void Population::createInitialHumans ()
 
 void Population::newHuman( SimTime dob ){
     util::streamValidate( dob.raw() );
-    population.push_back( new Host::Human (*_transmissionModel, dob) );
+    uint32_t id = nextHumanId;
+    ++nextHumanId;
+    Host::Human* h;
+    {
+        util::random::StreamScope stream( id, util::random::HUMAN_BIRTH, sim::nowOrTs0() );
+        h = new Host::Human (*_transmissionModel, dob);
+    }
+    pushHuman( h, id );
     ++recentBirths;
 }
 
+void Population::pushHuman( Host::Human* h, uint32_t id ){
+    assert( m_id.empty() || m_id.back() < id );  // see findHuman()
+    h->m_id = id;
+    population.push_back( h );
+    m_dob.push_back( h->getDateOfBirth() );
+    m_id.push_back( id );
+    indexLastBirth();
+}
+
+void Population::indexLastBirth(){
+    const SimTime dob = m_dob.back();
+    if( m_dob.size() == 1 ){
+        m_dobBase = dob;
+        m_dobIndex.assign( 1, 0 );
+    }
+    // Humans are appended in order of birth, so this one belongs to the last
+    // step indexed or a later one; steps in between are empty.
+    const size_t k = (dob - m_dobBase) / sim::oneTS();
+    if( m_dobIndex.size() < k + 2 )
+        m_dobIndex.resize( k + 2, m_dobIndex.back() );
+    ++m_dobIndex.back();
+}
+
+size_t Population::firstBornAfter( SimTime date ) const{
+    if( m_dobIndex.size() <= 1 || date < m_dobBase )
+        return 0;       // no humans, or all born after date
+    const size_t k = (date - m_dobBase) / sim::oneTS() + 1;
+    return k < m_dobIndex.size() ? m_dobIndex[k] : m_dobIndex.back();
+}
+
+bool Population::findHuman( uint32_t id, size_t& index ) const{
+    vector<uint32_t>::const_iterator it = lower_bound( m_id.begin(), m_id.end(), id );
+    if( it == m_id.end() || *it != id ) return false;
+    index = it - m_id.begin();
+    return true;
+}
+
+void Population::compact( const vector<char>& remove ){
+    assert( remove.size() == population.size() );
+    // We manipulate the underlying pointer array directly: this removes all
+    // humans in one pass where erase() would shift the tail each time.
+    vector<void*>& ptrs = population.base();
+    // The age index is updated in the same pass: entries pointing at index i
+    // are set to i's new index w.
+    const size_t nIndex = m_dobIndex.size();
+    size_t k = 0;
+    size_t w = 0;
+    for( size_t i = 0, n = ptrs.size(); i < n; ++i ){
+        while( k < nIndex && m_dobIndex[k] == i ){
+            m_dobIndex[k] = w;
+            ++k;
+        }
+        if( remove[i] ){
+            Host::Human* h = static_cast<Host::Human*>( ptrs[i] );
+            h->destroy();
+            delete h;
+        }else{
+            ptrs[w] = ptrs[i];
+            m_dob[w] = m_dob[i];
+            m_id[w] = m_id[i];
+            ++w;
+        }
+    }
+    for( ; k < nIndex; ++k )
+        m_dobIndex[k] = w;
+    ptrs.resize( w );
+    m_dob.resize( w );
+    m_id.resize( w );
+    
+    // Drop steps of the age index left empty at the start (the oldest
+    // humans were removed), moving m_dobBase on.
+    if( w == 0 ){
+        m_dobIndex.assign( 1, 0 );
+        return;
+    }
+    size_t nEmpty = 0;
+    while( m_dobIndex[nEmpty + 1] == 0 ) ++nEmpty;     // terminates: last entry is w
+    if( nEmpty > 0 ){
+        m_dobIndex.erase( m_dobIndex.begin(), m_dobIndex.begin() + nEmpty );
+        m_dobBase += sim::fromTS( nEmpty );
+    }
+}
+
 void Population::update1( SimTime firstVecInitTS ){
+    util::profile::Scope profileScope( util::profile::POP_UPDATE );
+    
     // This should only use humans being updated: otherwise too small a proportion
     // will be infected. However, we don't have another number to use instead.
     // NOTE: no neonatal mortalities will occur in the first 20 years of warmup
@@ -206,46 +321,51 @@ void Population::update1( SimTime firstVecInitTS ){
     int targetPop = populationSize;
     int cumPop = 0;
 
-    // Update each human in turn
-    //std::cout<<" time " <<t<<std::endl;
-    Iter last = population.end();
-    --last;
-    for (Iter iter = population.begin(); iter != population.end();) {
-        // Update human, and remove if too old.
-        // We only need to update humans who will survive past the end of the
-        // "one life span" init phase (this is an optimisation). lastPossibleTS
-        // is the time step they die at (some code still runs on this step).
-        SimTime lastPossibleTS = iter->getDateOfBirth() + sim::maxHumanAge();   // this is last time of possible update
-        bool updateHuman = lastPossibleTS >= firstVecInitTS;
-        bool isDead = iter->update(_transmissionModel, updateHuman);
-        if( isDead ){
-            iter->destroy();
-            iter = population.erase (iter);
-            continue;
+    // Update each human in turn (possibly using multiple threads). Humans are
+    // only flagged for removal here; see compact().
+    vector<char>& remove = m_remove;
+    if( util::parallel::numThreads() > 1 ){
+        updateHumansParallel( firstVecInitTS, remove );
+    } else {
+        remove.assign( population.size(), 0 );
+        for( size_t i = 0, n = population.size(); i < n; ++i ){
+            // Update human, and remove if too old.
+            // We only need to update humans who will survive past the end of the
+            // "one life span" init phase (this is an optimisation). lastPossibleTS
+            // is the time step they die at (some code still runs on this step).
+            SimTime lastPossibleTS = m_dob[i] + sim::maxHumanAge();   // this is last time of possible update
+            bool updateHuman = lastPossibleTS >= firstVecInitTS;
+            util::random::StreamScope stream( m_id[i], util::random::HUMAN_UPDATE, sim::ts0() );
+            remove[i] = population[i].update(_transmissionModel, updateHuman);
         }
+    }
+    
+    //BEGIN Population size & age structure
+    // Walks humans in order, oldest first. Humans flagged above have died.
+    // Counts are of people represented (see Human::weight()).
+    for( size_t i = 0, n = population.size(); i < n; ++i ){
+        if( remove[i] ) continue;
+        const int weight = population[i].weight();
+        cumPop += weight;
         
-        //BEGIN Population size & age structure
-        ++cumPop;
-
         // if (Actual number of people so far > target population size for this age)
         // "outmigrate" some to maintain population shape
         //NOTE: better to use age(sim::ts0())? Possibly, but the difference will not be very significant.
         // Also see targetPop = ... comment above
-        if( cumPop > AgeStructure::targetCumPop(iter->age(sim::ts1()).inSteps(), targetPop) ){
-            --cumPop;
-            iter->destroy();
-            iter = population.erase (iter);
-            continue;
+        if( cumPop > AgeStructure::targetCumPop((sim::ts1() - m_dob[i]).inSteps(), targetPop) ){
+            cumPop -= weight;
+            remove[i] = 1;
         }
-        //END Population size & age structure
-        ++iter;
-    } // end of per-human updates
+    }
+    compact( remove );
+    //END Population size & age structure
 
     // increase population size to targetPop
+    const int newWeight = util::CommandLine::getHumanWeight();
     while (cumPop < targetPop) {
         newHuman( sim::ts1() );        // humans born at end of this time step = beginning of next
         //++nCounter;
-        ++cumPop;
+        cumPop += newWeight;
     }
     
     // Doesn't matter whether non-updated humans are included (value isn't used
@@ -254,19 +374,72 @@ void Population::update1( SimTime firstVecInitTS ){
 }
 
 
+void Population::updateHumansParallel( SimTime firstVecInitTS, vector<char>& dead ){
+    dead.assign( population.size(), 0 );
+    
+    // Exceptions may not leave a parallel region; the first (by thread
+    // index) is recorded and thrown afterwards.
+    const size_t nThreads = util::parallel::numThreads();
+    vector<string> errMsg( nThreads );
+    vector<int> errCode( nThreads, util::Error::None );
+    
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        // Static partition: results only depend on the number of threads.
+        const size_t t = util::parallel::threadIndex();
+        const size_t n = population.size();
+        const size_t first = n * t / nThreads, end = n * (t+1) / nThreads;
+        try{
+            for( size_t i = first; i < end; ++i ){
+                // See comment on lastPossibleTS in update1()
+                SimTime lastPossibleTS = m_dob[i] + sim::maxHumanAge();
+                bool updateHuman = lastPossibleTS >= firstVecInitTS;
+                util::random::StreamScope stream( m_id[i], util::random::HUMAN_UPDATE, sim::ts0() );
+                dead[i] = population[i].update(_transmissionModel, updateHuman);
+            }
+        }catch( const util::base_exception& e ){
+            errMsg[t] = e.message();
+            errCode[t] = e.getCode();
+        }catch( const std::exception& e ){
+            errMsg[t] = e.what();
+            errCode[t] = util::Error::Default;
+        }
+    }
+    
+    for( size_t t = 0; t < nThreads; ++t ){
+        if( errCode[t] != util::Error::None ){
+            throw util::base_exception( errMsg[t], errCode[t] );
+        }
+    }
+    
+    // Add per-thread statistics into shared ones (in thread order)
+    mon::mergeThreadReports();
+    PopulationStats::mergeThreads();
+    Host::InfectionIncidenceModel::mergeThreads();
+    Clinical::mergeThreadInfantStats();
+}
+
+
 // -----  non-static methods: reporting  -----
 
 void Population::ctsHosts (ostream& stream){
     // this option is intended for debugging human initialization; normally this should equal populationSize.
-    stream << '\t' << population.size();
+    int nHosts = 0;
+    for (Iter iter = population.begin(); iter != population.end(); ++iter) {
+        nHosts += iter->weight();
+    }
+    stream << '\t' << nHosts;
 }
 void Population::ctsHostDemography (ostream& stream){
-    Population::ConstReverseIter it = population.crbegin();
+    // youngest humans are last
+    size_t i = m_dob.size();
     int cumCount = 0;
     BOOST_FOREACH( double ubound, ctsDemogAgeGroups ){
-        while( it != population.crend() && it->age(sim::now()).inYears() < ubound ){
-            ++cumCount;
-            ++it;
+        while( i > 0 && (sim::now() - m_dob[i-1]).inYears() < ubound ){
+            cumCount += population[i-1].weight();
+            --i;
         }
         stream << '\t' << cumCount;
     }
@@ -279,14 +452,14 @@ void Population::ctsPatentHosts (ostream& stream){
     int patent = 0;
     for (Iter iter = population.begin(); iter != population.end(); ++iter) {
         if( iter->getWithinHostModel().diagnosticResult(WithinHost::diagnostics::monitoringDiagnostic()) )
-            ++patent;
+            patent += iter->weight();
     }
     stream << '\t' << patent;
 }
 void Population::ctsImmunityh (ostream& stream){
     double x = 0.0;
     for (Iter iter = population.begin(); iter != population.end(); ++iter) {
-        x += iter->getWithinHostModel().getCumulative_h();
+        x += iter->getWithinHostModel().getCumulative_h() * iter->weight();
     }
     x /= populationSize;
     stream << '\t' << x;
@@ -294,24 +467,27 @@ void Population::ctsImmunityh (ostream& stream){
 void Population::ctsImmunityY (ostream& stream){
     double x = 0.0;
     for (Iter iter = population.begin(); iter != population.end(); ++iter) {
-        x += iter->getWithinHostModel().getCumulative_Y();
+        x += iter->getWithinHostModel().getCumulative_Y() * iter->weight();
     }
     x /= populationSize;
     stream << '\t' << x;
 }
 void Population::ctsMedianImmunityY (ostream& stream){
     vector<double> list;
-    list.reserve( populationSize );
+    list.reserve( population.size() );
     for (Iter iter = population.begin(); iter != population.end(); ++iter) {
         list.push_back( iter->getWithinHostModel().getCumulative_Y() );
     }
     sort( list.begin(), list.end() );
+    // Weights are uniform, so the median over simulated humans is the
+    // median over the people they represent.
+    const size_t n = list.size();
     double x;
-    if( mod_nn(populationSize, 2) == 0 ){
-        size_t i = populationSize / 2;
+    if( mod_nn(n, 2) == 0 ){
+        size_t i = n / 2;
         x = (list[i-1]+list[i])/2.0;
     }else{
-        x = list[populationSize / 2];
+        x = list[n / 2];
     }
     stream << '\t' << x;
 }
@@ -320,8 +496,8 @@ void Population::ctsMeanAgeAvailEffect (ostream& stream){
     double avail = 0.0;
     for (Iter iter = population.begin(); iter != population.end(); ++iter) {
         if( !iter->perHostTransmission.isOutsideTransmission() ){
-            ++nHumans;
-            avail += iter->perHostTransmission.relativeAvailabilityAge(iter->age(sim::now()).inYears());
+            nHumans += iter->weight();
+            avail += iter->perHostTransmission.relativeAvailabilityAge(iter->age(sim::now()).inYears()) * iter->weight();
         }
     }
     stream << '\t' << avail/nHumans;
@@ -329,7 +505,8 @@ void Population::ctsMeanAgeAvailEffect (ostream& stream){
 void Population::ctsITNCoverage (ostream& stream){
     int nActive = 0;
     for (Iter iter = population.begin(); iter != population.end(); ++iter) {
-        nActive += iter->perHostTransmission.hasActiveInterv( interventions::Component::ITN );
+        if( iter->perHostTransmission.hasActiveInterv( interventions::Component::ITN ) )
+            nActive += iter->weight();
     }
     double coverage = static_cast<double>(nActive) / populationSize;
     stream << '\t' << coverage;
@@ -337,7 +514,8 @@ void Population::ctsITNCoverage (ostream& stream){
 void Population::ctsIRSCoverage (ostream& stream){
     int nActive = 0;
     for (Iter iter = population.begin(); iter != population.end(); ++iter) {
-        nActive += iter->perHostTransmission.hasActiveInterv( interventions::Component::IRS );
+        if( iter->perHostTransmission.hasActiveInterv( interventions::Component::IRS ) )
+            nActive += iter->weight();
     }
     double coverage = static_cast<double>(nActive) / populationSize;
     stream << '\t' << coverage;
@@ -345,7 +523,8 @@ void Population::ctsIRSCoverage (ostream& stream){
 void Population::ctsGVICoverage (ostream& stream){
     int nActive = 0;
     for (Iter iter = population.begin(); iter != population.end(); ++iter) {
-        nActive += iter->perHostTransmission.hasActiveInterv( interventions::Component::GVI );
+        if( iter->perHostTransmission.hasActiveInterv( interventions::Component::GVI ) )
+            nActive += iter->weight();
     }
     double coverage = static_cast<double>(nActive) / populationSize;
     stream << '\t' << coverage;
@@ -26,9 +26,10 @@
 #include "Host/Human.h"
 #include "Transmission/TransmissionModel.h"
 
-#include <boost/ptr_container/ptr_list.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 #include <fstream>
 
+class SubPopIndexSuite;
 namespace scnXml{
     class Entomology;
     class Scenario;
@@ -57,6 +58,7 @@ public:
     void operator& (S& stream) {
         populationSize & stream;
 	recentBirths & stream;
+        nextHumanId & stream;
         (*_transmissionModel) & stream;
 	
         checkpoint (stream);
@@ -86,8 +88,10 @@ public:
     void flushReports();
     
     /// Type of population list. Store pointers to humans only to avoid copy
-    /// operations which (AFAIAA) are otherwise required in C++98.
-    typedef boost::ptr_list<Host::Human> HumanPop;
+    /// operations which (AFAIAA) are otherwise required in C++98. The
+    /// pointers are stored contiguously (ordered oldest to youngest); removal
+    /// is done in a single compaction pass per step (see compact()).
+    typedef boost::ptr_vector<Host::Human> HumanPop;
     /// Iterator type of population
     typedef HumanPop::iterator Iter;
     /// Const iterator type of population
@@ -109,6 +113,30 @@ public:
         return populationSize;
     }
     //@}
+    
+    /** @brief Access humans by index (0 is the oldest), and per-human data
+     * stored in arrays parallel to the population. These are copies of data
+     * fixed at birth; sweeps over the population can read them without
+     * touching each Human. Indices are valid until the next update1(). */
+    //@{
+    inline Host::Human& human( size_t i ){ return population[i]; }
+    inline const Host::Human& human( size_t i ) const{ return population[i]; }
+    /// Date of birth of human i
+    inline SimTime dateOfBirth( size_t i ) const{ return m_dob[i]; }
+    /// Identifier of human i (see Host::Human::id())
+    inline uint32_t humanId( size_t i ) const{ return m_id[i]; }
+    /** Find the human with identifier id. Returns false if there is no such
+     * human (e.g. it died), otherwise sets index such that
+     * humanId(index) == id. */
+    bool findHuman( uint32_t id, size_t& index ) const;
+    /** Set [first, last) to the range of indices of humans whose age at time
+     * t is at least minAge and less than maxAge. O(1), using the age index. */
+    inline void ageRange( SimTime t, SimTime minAge, SimTime maxAge,
+                          size_t& first, size_t& last ) const{
+        first = firstBornAfter( t - maxAge );
+        last = max( first, firstBornAfter( t - minAge ) );
+    }
+    //@}
     /** Return access to the transmission model. */
     inline Transmission::TransmissionModel& transmissionModel() {
         return *_transmissionModel;
@@ -118,12 +146,37 @@ public:
     }
 
 private:
+    /** Constructor for unit tests: an empty population without transmission
+     * model or continuous reporting. Add humans with pushHuman(). */
+    Population();
+    
     //! Creates initializes and add to the population list a new uninfected human
     /*!
        \param dob date of birth (usually current time)
     */
     void newHuman( SimTime dob );
     
+    /// Append h (with identifier id) to population, updating per-human arrays.
+    void pushHuman( Host::Human* h, uint32_t id );
+    
+    /// Add the last human of m_dob to the age index (m_dobBase, m_dobIndex).
+    void indexLastBirth();
+    
+    /// Index of the first human born after date (number of humans if none).
+    size_t firstBornAfter( SimTime date ) const;
+    
+    /** Remove humans i where remove[i] is non-zero (calling destroy() on
+     * them), and compact population, per-human arrays and the age index,
+     * keeping order. */
+    void compact( const vector<char>& remove );
+    
+    /** Call Human::update() on all humans, using util::parallel::numThreads()
+     * threads. Each thread updates a contiguous range of the population.
+     * 
+     * @param dead Output: entry i is set to 1 if the i-th human (in list
+     *  order) died, 0 otherwise. */
+    void updateHumansParallel( SimTime firstVecInitTS, vector<char>& dead );
+    
     /// Delegate to print the number of hosts
     void ctsHosts (ostream& stream);
     /// Delegate to print cumulative numbers of hosts under various age limits
@@ -160,6 +213,9 @@ private:
     /// Births since last continuous output
     int recentBirths;
     //@}
+    
+    /// Identifier given to the next human created
+    uint32_t nextHumanId;
 public:
     //! TransmissionModel model
     Transmission::TransmissionModel* _transmissionModel;
@@ -170,7 +226,33 @@ private:
      * The list of all humans, ordered from oldest to youngest. */
     HumanPop population;
     
+    ///@brief Per-human data parallel to population (same indices)
+    //@{
+    vector<SimTime> m_dob;
+    /// Identifier of each human (unique within a run; used to select
+    /// random-number streams, see util::random::beginStream()). Humans are
+    /// created in order of identifier, so this is sorted.
+    vector<uint32_t> m_id;
+    //@}
+    
+    /** @brief Age index
+     * 
+     * Dates of birth are whole time steps and are weakly increasing along the
+     * population, so the humans born on each step form a contiguous range.
+     * m_dobIndex[k] is the index of the first human born no earlier than
+     * m_dobBase + k steps, where m_dobBase is the date of birth of the
+     * oldest human; the last entry is the number of humans. Kept up to date
+     * by pushHuman() (see indexLastBirth()) and compact(). */
+    //@{
+    SimTime m_dobBase;
+    vector<size_t> m_dobIndex;
+    //@}
+    
+    /// Per-step flags (indexed like population); kept to avoid reallocation
+    vector<char> m_remove;
+    
     friend class AnophelesModelSuite;
+    friend class ::SubPopIndexSuite;
 };
 
 }
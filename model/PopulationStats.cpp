@@ -25,6 +25,24 @@ namespace OM {
     boost::int64_t PopulationStats::allowedInfections =0;
     boost::int64_t PopulationStats::humanUpdateCalls =0;
     boost::int64_t PopulationStats::humanUpdates =0;
+    boost::int64_t PopulationStats::humanIdleUpdates =0;
+    vector<PopulationStats::ThreadCounts> PopulationStats::threadCounts;
+    
+    void PopulationStats::init() {
+	threadCounts.assign( util::parallel::numThreads() - 1, ThreadCounts() );
+    }
+    
+    void PopulationStats::mergeThreads() {
+	for( size_t t = 0; t < threadCounts.size(); ++t ){
+	    ThreadCounts& counts = threadCounts[t];
+	    totalInfections += counts.totalInfections;
+	    allowedInfections += counts.allowedInfections;
+	    humanUpdateCalls += counts.humanUpdateCalls;
+	    humanUpdates += counts.humanUpdates;
+	    humanIdleUpdates += counts.humanIdleUpdates;
+	    counts = ThreadCounts();
+	}
+    }
     
     void PopulationStats::print() {
 #	ifdef WITHOUT_BOINC
@@ -43,6 +61,14 @@ namespace OM {
 	    <<"\t("<<x<<"% skipped)"
 	    <<endl
 	;
+	
+	x = 100.0 * humanIdleUpdates / humanUpdates;
+	cerr
+	    << "Idle host updates: "
+	    <<humanIdleUpdates
+	    <<"\t("<<x<<"% of updates)"
+	    <<endl
+	;
 #	else	// use reduced-output mode
 	cerr<<"T/A: "<<totalInfections<<"/"<<allowedInfections<<endl;
 #	endif
@@ -53,12 +79,14 @@ namespace OM {
 	allowedInfections & stream;
 	humanUpdateCalls & stream;
 	humanUpdates & stream;
+	humanIdleUpdates & stream;
     }
     void PopulationStats::staticCheckpoint (ostream& stream){
 	totalInfections & stream;
 	allowedInfections & stream;
 	humanUpdateCalls & stream;
 	humanUpdates & stream;
+	humanIdleUpdates & stream;
     }
     
 }
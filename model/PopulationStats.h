@@ -25,6 +25,7 @@
 #define Hmod_PopStats
 
 #include "Global.h"
+#include "util/parallel.h"
 
 namespace OM {
     class PopulationStats {
@@ -36,11 +37,67 @@ namespace OM {
 	static void staticCheckpoint (istream& stream);
 	static void staticCheckpoint (ostream& stream); ///< ditto
 	
+	/** Allocate counters for threads other than the first. Call after
+	 * util::parallel::init(). */
+	static void init ();
+	
+	/** Add counters of threads other than the first into the totals below.
+	 * Call outside of parallel regions. */
+	static void mergeThreads ();
+	
+	/// Count infections: total introduced, and those allowed (not prevented
+	/// by WHInterface::MAX_INFECTIONS)
+	static inline void addInfections (int total, int allowed){
+	    const size_t thread = util::parallel::threadIndex();
+	    if( thread == 0 ){
+		totalInfections += total;
+		allowedInfections += allowed;
+	    }else{
+		ThreadCounts& counts = threadCounts[thread-1];
+		counts.totalInfections += total;
+		counts.allowedInfections += allowed;
+	    }
+	}
+	
+	/// Count a call to Human::update(): whether the human was updated, and
+	/// if so whether it was idle (see WHInterface::isIdle())
+	static inline void addHumanUpdate (bool updated, bool idle){
+	    const size_t thread = util::parallel::threadIndex();
+	    if( thread == 0 ){
+		humanUpdateCalls += 1;
+		humanUpdates += updated ? 1 : 0;
+		humanIdleUpdates += idle ? 1 : 0;
+	    }else{
+		ThreadCounts& counts = threadCounts[thread-1];
+		counts.humanUpdateCalls += 1;
+		counts.humanUpdates += updated ? 1 : 0;
+		counts.humanIdleUpdates += idle ? 1 : 0;
+	    }
+	}
+	
 	static boost::int64_t totalInfections;
 	static boost::int64_t allowedInfections;
 	
 	static boost::int64_t humanUpdateCalls;
 	static boost::int64_t humanUpdates;
+	/// Updates of hosts which were idle (see WHInterface::isIdle())
+	static boost::int64_t humanIdleUpdates;
+	
+    private:
+	/// Counters of one thread. Padded so that threads don't share cache lines.
+	struct ThreadCounts {
+	    ThreadCounts() : totalInfections(0), allowedInfections(0),
+		humanUpdateCalls(0), humanUpdates(0), humanIdleUpdates(0) {}
+	    boost::int64_t totalInfections;
+	    boost::int64_t allowedInfections;
+	    boost::int64_t humanUpdateCalls;
+	    boost::int64_t humanUpdates;
+	    boost::int64_t humanIdleUpdates;
+	    char padding[64];
+	};
+	/// Counters of threads 1, 2, ... during parallel updates (thread 0 uses
+	/// the totals directly); zero after merging
+	static vector<ThreadCounts> threadCounts;
     };
 }
 
@@ -31,13 +31,18 @@
 #include "WithinHost/Diagnostic.h"
 #include "WithinHost/Genotypes.h"
 #include "mon/management.h"
+#include "util/AgeGroupInterpolation.h"
 #include "util/BoincWrapper.h"
 #include "util/timer.h"
 #include "util/CommandLine.h"
 #include "util/ModelOptions.h"
 #include "util/errors.h"
 #include "util/random.h"
+#include "util/parallel.h"
+#include "util/profile.h"
 #include "util/StreamValidator.h"
+#include "util/checkpoint_sections.h"
+#include "util/checkpoint_writer.h"
 #include "schema/scenario.h"
 
 #include <fstream>
@@ -69,26 +74,40 @@ enum Phase {
     MAIN_PHASE,
     END_SIM         // should have largest value of all enumerations
 };
+/// Names of the above, as written by --phase-times
+const char* phaseNames[] = { "STARTING_PHASE", "ONE_LIFE_SPAN",
+    "TRANSMISSION_INIT", "MAIN_PHASE" };
 
 
 // ———  Set-up & tear-down  ———
 
-Simulator::Simulator( util::Checksum ck, const scnXml::Scenario& scenario ) :
+Simulator::Simulator( util::Checksum ck, boost::uint64_t warmupCk, const scnXml::Scenario& scenario ) :
     simPeriodEnd(sim::zero()),
     totalSimDuration(sim::zero()),
     phase(STARTING_PHASE),
     workUnitIdentifier(0),
-    cksum(ck)
+    cksum(ck),
+    warmupCksum(warmupCk),
+    startTime(util::timer::wallTime())
 {
     // ———  Initialise static data  ———
     
     const scnXml::Model& model = scenario.getModel();
     
+    // 0) threading: other modules allocate per-thread data during init
+    util::parallel::init( util::CommandLine::getNumThreads() );
+    util::profile::init();
+    PopulationStats::init();
+    
     // 1) elements with no dependencies on other elements initialised here:
     sim::init( scenario );
     Parameters parameters( model.getParameters() );     // depends on nothing
     WithinHost::Genotypes::init( scenario );
     
+    if( util::CommandLine::option( util::CommandLine::COUNTER_RNG ) )
+        util::random::useCounterGenerator();
+    util::AgeGroupInterpolator::setTabulate(
+        util::CommandLine::option( util::CommandLine::TABULATE_AGE_GROUPS ) );
     util::random::seed( model.getParameters().getIseed() );
     util::ModelOptions::init( model.getModelOptions() );
     
@@ -162,13 +181,21 @@ void Simulator::start(const scnXml::Monitoring& monitoring){
         readCheckpoint();
     } else {
         Continuous.init( monitoring, false );
-        population->createInitialHumans();
+        if( util::CommandLine::getLoadWarmupName().empty() )
+            population->createInitialHumans();
+        else
+            readWarmup();       // continues at the end of TRANSMISSION_INIT
     }
     // Set to either a checkpointing time step or min int value. We only need to
     // set once, since we exit after a checkpoint triggered this way.
     SimTime testCheckpointTime = util::CommandLine::getNextCheckpointTime( sim::now() );
     SimTime testCheckpointDieTime = testCheckpointTime;        // kill program at same time
     
+    // Wall-clock time spent in each phase (for --phase-times)
+    vector<double> phaseTimes( END_SIM + 1, 0.0 );
+    double phaseStartTime = util::timer::wallTime();
+    const double initTime = phaseStartTime - startTime;
+    
     // phase loop
     while (true){
         // loop for steps within a phase
@@ -176,8 +203,8 @@ void Simulator::start(const scnXml::Monitoring& monitoring){
             // checkpoint
             if( util::BoincWrapper::timeToCheckpoint() || testCheckpointTime == sim::now() ){
                 writeCheckpoint();
-                util::BoincWrapper::checkpointCompleted();
             }
+            finishCheckpoint( testCheckpointDieTime == sim::now() );
             if( testCheckpointDieTime == sim::now() ){
                 throw util::cmd_exception ("Checkpoint test: checkpoint written", util::Error::None);
             }
@@ -203,8 +230,12 @@ void Simulator::start(const scnXml::Monitoring& monitoring){
             //  sim::ts1(), to replace those lost.
             
             // do reporting (continuous and surveys)
-            Continuous.update( *population );
+            {
+                util::profile::Scope profileScope( util::profile::CONTINUOUS );
+                Continuous.update( *population );
+            }
             if( sim::intervNow() == mon::nextSurveyTime() ){
+                util::profile::Scope profileScope( util::profile::SURVEYS );
                 population->newSurvey();
                 mon::concludeSurvey();
             }
@@ -232,6 +263,10 @@ void Simulator::start(const scnXml::Monitoring& monitoring){
                 static_cast<double>(totalSimDuration.raw()) );
         }
         
+        const double phaseEndTime = util::timer::wallTime();
+        phaseTimes[phase] += phaseEndTime - phaseStartTime;
+        phaseStartTime = phaseEndTime;
+        
         ++phase;        // advance to next phase
         if (phase == ONE_LIFE_SPAN) {
             simPeriodEnd = humanWarmupLength;
@@ -245,6 +280,11 @@ void Simulator::start(const scnXml::Monitoring& monitoring){
             }
             // adjust estimation of final time step: end of current period + length of main phase
             totalSimDuration = simPeriodEnd + mon::finalSurveyTime() + sim::oneTS();
+            if( phase == TRANSMISSION_INIT && !util::CommandLine::getSaveWarmupName().empty() ){
+                writeWarmup();  // warm-up complete
+                if( util::CommandLine::getWarmupOnly() )
+                    throw util::cmd_exception ("warm-up snapshot written", util::Error::None);
+            }
         } else if (phase == MAIN_PHASE) {
             // Start MAIN_PHASE:
             simPeriodEnd = totalSimDuration;
@@ -275,6 +315,8 @@ void Simulator::start(const scnXml::Monitoring& monitoring){
         }
     }
     
+    finishCheckpoint( true );
+    
     // Open a critical section; should prevent app kill while/after writing
     // output.txt, which we don't currently handle well.
     // Note: we don't end this critical section; we simply exit.
@@ -282,15 +324,42 @@ void Simulator::start(const scnXml::Monitoring& monitoring){
     
     PopulationStats::print();
     
-    population->flushReports();        // ensure all Human instances report past events
-    mon::writeSurveyData();
+    {
+        util::profile::Scope profileScope( util::profile::SURVEYS );
+        population->flushReports();        // ensure all Human instances report past events
+        mon::writeSurveyData();
+    }
     Continuous.finalise();
     
+    phaseTimes[0] += initTime;
+    writePhaseTimes( phaseTimes, util::timer::wallTime() - phaseStartTime );
+    util::profile::write( util::CommandLine::getProfileName() );
+    
 # ifdef OM_STREAM_VALIDATOR
     util::StreamValidator.saveStream();
 # endif
 }
 
+void Simulator::writePhaseTimes (const vector<double>& times, double outputTime){
+    const string name = util::CommandLine::getPhaseTimesName();
+    if( name.empty() ) return;
+    
+    // One "name<tab>seconds" line per phase. Initialisation (before the
+    // first time step) is included in STARTING_PHASE and time spent writing
+    // outputs is listed as OUTPUT.
+    ofstream file( name.c_str() );
+    double total = outputTime;
+    for( size_t i = 0; i < END_SIM; ++i ){
+        file << phaseNames[i] << '\t' << times[i] << '\n';
+        total += times[i];
+    }
+    file << "OUTPUT\t" << outputTime << '\n';
+    file << "TOTAL\t" << total << endl;
+    if( !file ){
+        throw util::base_exception( string("unable to write ").append(name) );
+    }
+}
+
 
 // ———  checkpointing: set up read/write stream  ———
 
@@ -309,6 +378,9 @@ void Simulator::writeCheckpoint(){
     // We alternate between two checkpoints, in case program is closed while writing.
     const int NUM_CHECKPOINTS = 2;
     
+    // The pointer file must be up to date before we choose the next number.
+    finishCheckpoint( true );
+    
     int oldCheckpointNum = 0, checkpointNum = 0;
     if (isCheckpoint()) {
         oldCheckpointNum = readCheckpointNum();
@@ -316,13 +388,38 @@ void Simulator::writeCheckpoint(){
         checkpointNum = mod_nn(oldCheckpointNum + 1, NUM_CHECKPOINTS);
     }
     
+    bool compress = util::CommandLine::option (util::CommandLine::COMPRESS_CHECKPOINTS);
+    ostringstream name, oldName;
+    name << CHECKPOINT << checkpointNum;
+    oldName << CHECKPOINT << oldCheckpointNum;
+    if (compress) {
+        name << ".gz";
+        oldName << ".gz";
+    }
+    // Truncate the old checkpoint to save disk space, when it existed
+    bool truncateOld = oldCheckpointNum != checkpointNum
+        && !util::CommandLine::option (
+            util::CommandLine::TEST_DUPLICATE_CHECKPOINTS
+        );      /* need original in this case */
+    
+    if (util::CommandLine::option (util::CommandLine::ASYNC_CHECKPOINTS)) {
+        // Serialise to memory now; compression, writing and updating the
+        // pointer file happen in the background (see finishCheckpoint()).
+        string data;
+        {
+            util::checkpoint::StringBuf buf (data);
+            ostream out (&buf);
+            checkpoint (out, checkpointNum);
+        }
+        util::checkpoint::background::start( data, name.str(), compress,
+                CHECKPOINT, checkpointNum, truncateOld ? oldName.str() : string() );
+        return;
+    }
+    
     {   // Open the next checkpoint file for writing:
-        ostringstream name;
-        name << CHECKPOINT << checkpointNum;
         //Writing checkpoint:
 //      cerr << sim::now() << " WC: " << name.str();
-        if (util::CommandLine::option (util::CommandLine::COMPRESS_CHECKPOINTS)) {
-            name << ".gz";
+        if (compress) {
             ogzstream out(name.str().c_str(), ios::out | ios::binary);
             checkpoint (out, checkpointNum);
             out.close();
@@ -333,29 +430,53 @@ void Simulator::writeCheckpoint(){
         }
     }
     
-    {   // Indicate which is the latest checkpoint file.
-        ofstream checkpointFile;
-        checkpointFile.open(CHECKPOINT,ios::out);
-        checkpointFile << checkpointNum;
-        checkpointFile.close();
-        if (!checkpointFile)
-            throw util::checkpoint_error ("error writing to file \"checkpoint\"");
-    }
-    // Truncate the old checkpoint to save disk space, when it existed
-    if( oldCheckpointNum != checkpointNum
-        && !util::CommandLine::option (
-            util::CommandLine::TEST_DUPLICATE_CHECKPOINTS
-        )       /* need original in this case */
-    ) {
-        ostringstream name;
-        name << CHECKPOINT << oldCheckpointNum;
-        if (util::CommandLine::option (util::CommandLine::COMPRESS_CHECKPOINTS)) {
-            name << ".gz";
-        }
-        ofstream out(name.str().c_str(), ios::out | ios::binary);
+    // Indicate which is the latest checkpoint file.
+    util::checkpoint::writePointerFile (CHECKPOINT, checkpointNum);
+    
+    if (truncateOld) {
+        ofstream out(oldName.str().c_str(), ios::out | ios::binary);
         out.close();
     }
 //     cerr << " OK" << endl;
+    util::BoincWrapper::checkpointCompleted();
+}
+
+void Simulator::finishCheckpoint (bool wait) {
+    if( !util::checkpoint::background::pending() ) return;
+    if( wait || util::checkpoint::background::completed() ){
+        util::checkpoint::background::finish();
+        util::BoincWrapper::checkpointCompleted();
+    }
+}
+
+bool isGzName (const string& name) {
+    return name.size() >= 3 && name.compare( name.size() - 3, 3, ".gz" ) == 0;
+}
+
+void Simulator::writeWarmup(){
+    const string name = util::CommandLine::getSaveWarmupName();
+    if( isGzName( name ) ){
+        ogzstream out(name.c_str(), ios::out | ios::binary);
+        checkpoint (out, -1, true);
+        out.close();
+    } else {
+        ofstream out(name.c_str(), ios::out | ios::binary);
+        checkpoint (out, -1, true);
+        out.close();
+    }
+}
+
+void Simulator::readWarmup(){
+    const string name = util::CommandLine::getLoadWarmupName();
+    util::checkpoint::FileData file;
+    if( !file.load( name, isGzName( name ) ) )
+        throw util::checkpoint_error ("unable to read warm-up snapshot " + name);
+    checkpoint (file, -1, true);
+    
+    // Monitoring may differ from that used when writing the snapshot
+    for( Population::Iter it = population->begin(); it != population->end(); ++it )
+        it->resetMonitoringAgeGroup();
+    totalSimDuration = simPeriodEnd + mon::finalSurveyTime() + sim::oneTS();
 }
 
 void Simulator::readCheckpoint() {
@@ -364,19 +485,13 @@ void Simulator::readCheckpoint() {
   // Open the latest file
   ostringstream name;
   name << CHECKPOINT << checkpointNum;  // try uncompressed
-  ifstream in(name.str().c_str(), ios::in | ios::binary);
-  if (in.good()) {
-    checkpoint (in, checkpointNum);
-    in.close();
-  } else {
+  util::checkpoint::FileData file;
+  if( !file.load( name.str(), false ) ){
     name << ".gz";                              // then compressed
-    igzstream in(name.str().c_str(), ios::in | ios::binary);
-    //Note: gzstreams are considered "good" when file not open!
-    if ( !( in.good() && in.rdbuf()->is_open() ) )
+    if( !file.load( name.str(), true ) )
       throw util::checkpoint_error ("Unable to read file");
-    checkpoint (in, checkpointNum);
-    in.close();
   }
+  checkpoint (file, checkpointNum);
   
   // Keep size of stderr.txt minimal with a short message, since this is a common message:
   cerr << sim::now() << " RC" << endl;
@@ -389,85 +504,141 @@ void Simulator::readCheckpoint() {
 
 // ———  checkpointing: Simulation data  ———
 
-void Simulator::checkpoint (istream& stream, int checkpointNum) {
+// Section versions: increment when the data written to a section changes.
+const uint32_t V_STATIC = 2;
+const uint32_t V_SIMULATOR = 1;
+const uint32_t V_POPULATION = 4;
+const uint32_t V_POPULATION_STATS = 2;
+const uint32_t V_INTERVENTIONS = 1;
+const uint32_t V_RANDOM = 1;
+const uint32_t V_IDENTIFIER = 1;
+// Sections only in warm-up snapshots:
+const uint32_t V_WARMUP_STATIC = 1;
+const uint32_t V_WARMUP_IDENTIFIER = 1;
+
+void Simulator::checkpoint (const util::checkpoint::FileData& file, int checkpointNum, bool warmup) {
+    util::checkpoint::SectionReader reader (file.data(), file.size());
     try {
-        util::checkpoint::header (stream);
-        util::CommandLine::staticCheckpoint (stream);
-        Population::staticCheckpoint (stream);
-        Continuous & stream;
-        mon::checkpoint( stream );
+        if( warmup ){
+            // Check first that the scenario matches that the snapshot was
+            // written with, apart from interventions and monitoring:
+            istream& stream = reader.open ("warm-up identifier", V_WARMUP_IDENTIFIER);
+            boost::uint64_t oldCksum = warmupCksum;
+            warmupCksum & stream;
+            reader.close ();
+            if (warmupCksum != oldCksum)
+                throw util::checkpoint_error ("warm-up snapshot was written for a scenario differing in more than interventions and monitoring");
+        }
+        
+        istream* stream = warmup ? &reader.open ("warm-up static", V_WARMUP_STATIC)
+            : &reader.open ("static", V_STATIC);
+        util::CommandLine::staticCheckpoint (*stream);
+        Population::staticCheckpoint (*stream);
+        if( !warmup ){
+            Continuous & *stream;
+            mon::checkpoint( *stream );
+        }
 #       ifdef OM_STREAM_VALIDATOR
-        util::StreamValidator & stream;
+        util::StreamValidator & *stream;
 #       endif
+        reader.close ();
+        
+        stream = &reader.open ("simulator", V_SIMULATOR);
+        sim::interv_time & *stream;
+        simPeriodEnd & *stream;
+        totalSimDuration & *stream;
+        phase & *stream;
+        reader.close ();
         
-        sim::interv_time & stream;
-        simPeriodEnd & stream;
-        totalSimDuration & stream;
-        phase & stream;
-        (*population) & stream;
-        PopulationStats::staticCheckpoint( stream );
-        InterventionManager::checkpoint( stream );
-        InterventionManager::loadFromCheckpoint( *population, sim::interv_time );
+        stream = &reader.open ("population", V_POPULATION);
+        (*population) & *stream;
+        reader.close ();
+        
+        stream = &reader.open ("population stats", V_POPULATION_STATS);
+        PopulationStats::staticCheckpoint( *stream );
+        reader.close ();
+        
+        if( !warmup ){
+            stream = &reader.open ("interventions", V_INTERVENTIONS);
+            InterventionManager::checkpoint( *stream );
+            reader.close ();
+            InterventionManager::loadFromCheckpoint( *population, sim::interv_time );
+        }
         
         // read last, because other loads may use random numbers or expect time
         // to be negative
-        sim::time0 & stream;
-        sim::time1 & stream;
-        util::random::checkpoint (stream, checkpointNum);
+        stream = &reader.open ("random", V_RANDOM);
+        sim::time0 & *stream;
+        sim::time1 & *stream;
+        util::random::checkpoint (*stream, warmup ? -1 : checkpointNum);
+        reader.close ();
+        
+        if( warmup ) return;    // identifier checked above
         
         // Check scenario.xml and checkpoint files correspond:
+        stream = &reader.open ("identifier", V_IDENTIFIER);
         int oldWUID = workUnitIdentifier;
         util::Checksum oldCksum(cksum);
-        workUnitIdentifier & stream;
-        cksum & stream;
+        workUnitIdentifier & *stream;
+        cksum & *stream;
+        reader.close ();
         if (workUnitIdentifier != oldWUID || cksum != oldCksum)
             throw util::checkpoint_error ("mismatched checkpoint");
-    } catch (const util::checkpoint_error& e) { // append " (pos X of Y bytes)"
-        ostringstream pos;
-        pos<<" (pos "<<stream.tellg()<<" of ";
-        stream.ignore (numeric_limits<streamsize>::max()-1);    // skip to end of file
-        pos<<stream.tellg()<<" bytes)";
-        throw util::checkpoint_error( e.what() + pos.str() );
+    } catch (const util::checkpoint_error& e) { // append " (section X)"
+        throw util::checkpoint_error( e.what() + (" (section " + reader.current() + ")") );
     }
-    
-    
-    stream.ignore (numeric_limits<streamsize>::max()-1);        // skip to end of file
-    if (stream.gcount () != 0) {
-        ostringstream msg;
-        msg << "Checkpointing file has " << stream.gcount() << " bytes remaining." << endl;
-        throw util::checkpoint_error (msg.str());
-    } else if (stream.fail())
-        throw util::checkpoint_error ("stream read error");
 }
 
-void Simulator::checkpoint (ostream& stream, int checkpointNum) {
-    util::checkpoint::header (stream);
+void Simulator::checkpoint (ostream& stream, int checkpointNum, bool warmup) {
     if (stream == NULL || !stream.good())
         throw util::checkpoint_error ("Unable to write to file");
     util::timer::startCheckpoint ();
-    
-    util::CommandLine::staticCheckpoint (stream);
-    Population::staticCheckpoint (stream);
-    Continuous & stream;
-    mon::checkpoint( stream );
+    util::checkpoint::SectionWriter writer (stream);
+    
+    ostream* section = warmup ? &writer.begin ("warm-up static", V_WARMUP_STATIC)
+        : &writer.begin ("static", V_STATIC);
+    util::CommandLine::staticCheckpoint (*section);
+    Population::staticCheckpoint (*section);
+    if( !warmup ){
+        Continuous & *section;
+        mon::checkpoint( *section );
+    }
 # ifdef OM_STREAM_VALIDATOR
-    util::StreamValidator & stream;
+    util::StreamValidator & *section;
 # endif
     
-    sim::interv_time & stream;
-    simPeriodEnd & stream;
-    totalSimDuration & stream;
-    phase & stream;
-    (*population) & stream;
-    PopulationStats::staticCheckpoint( stream );
-    InterventionManager::checkpoint( stream );
+    section = &writer.begin ("simulator", V_SIMULATOR);
+    sim::interv_time & *section;
+    simPeriodEnd & *section;
+    totalSimDuration & *section;
+    phase & *section;
     
-    sim::time0 & stream;
-    sim::time1 & stream;
-    util::random::checkpoint (stream, checkpointNum);
-    workUnitIdentifier & stream;
-    cksum & stream;
+    section = &writer.begin ("population", V_POPULATION);
+    (*population) & *section;
+    
+    section = &writer.begin ("population stats", V_POPULATION_STATS);
+    PopulationStats::staticCheckpoint( *section );
+    
+    if( !warmup ){
+        section = &writer.begin ("interventions", V_INTERVENTIONS);
+        InterventionManager::checkpoint( *section );
+    }
+    
+    section = &writer.begin ("random", V_RANDOM);
+    sim::time0 & *section;
+    sim::time1 & *section;
+    util::random::checkpoint (*section, warmup ? -1 : checkpointNum);
+    
+    if( warmup ){
+        section = &writer.begin ("warm-up identifier", V_WARMUP_IDENTIFIER);
+        warmupCksum & *section;
+    } else {
+        section = &writer.begin ("identifier", V_IDENTIFIER);
+        workUnitIdentifier & *section;
+        cksum & *section;
+    }
     
+    writer.finish ();
     util::timer::stopCheckpoint ();
     if (stream.fail())
         throw util::checkpoint_error ("stream write error");
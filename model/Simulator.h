@@ -35,12 +35,20 @@ namespace OM {
 namespace interventions{
     class InterventionManager;
 }
+namespace util { namespace checkpoint {
+    class FileData;
+} }
     
 //! Main simulation class
 class Simulator{
 public: 
-    //!  Inititalise all step specific constants and variables.
-    Simulator( util::Checksum ck, const scnXml::Scenario& scenario );
+    /** Inititalise all step specific constants and variables.
+     * 
+     * @param ck Checksum of the scenario file
+     * @param warmupCk Checksum of the parts of the scenario a warm-up
+     *  snapshot depends on (see DocumentLoader::warmupChecksum())
+     * @param scenario The scenario document */
+    Simulator( util::Checksum ck, boost::uint64_t warmupCk, const scnXml::Scenario& scenario );
     
     //! Entry point to simulation.
     void start(const scnXml::Monitoring& monitoring);
@@ -52,15 +60,41 @@ private:
     /** @brief checkpointing functions
     *
     * readCheckpoint/writeCheckpoint prepare to read/write the file,
-    * and read/write read and write the actual data. */
+    * and read/write read and write the actual data (one section per
+    * subsystem; see util/checkpoint_sections.h). */
     //@{
     void writeCheckpoint();
+    /** If a checkpoint is being written in the background and has completed
+     * (or wait is true, in which case block until it has), report any error
+     * and tell BOINC the checkpoint is complete. */
+    void finishCheckpoint (bool wait);
     void readCheckpoint();
     
-    void checkpoint (istream& stream, int checkpointNum);
-    void checkpoint (ostream& stream, int checkpointNum);
+    /** Read or write all data. If warmup is true, this is a warm-up snapshot
+     * (see writeWarmup()): data depending on interventions or monitoring
+     * is omitted, as is the scenario checksum (warmupCksum is used instead).
+     * checkpointNum is not used in this case. */
+    void checkpoint (const util::checkpoint::FileData& file, int checkpointNum, bool warmup = false);
+    void checkpoint (ostream& stream, int checkpointNum, bool warmup = false);
+    
+    /** Write a warm-up snapshot to the file named by --save-warmup. Called at
+     * the end of the warm-up (the last time step before the main phase).
+     * 
+     * The snapshot is a checkpoint with the same sections, except for those
+     * holding intervention and monitoring data, so that it can be loaded by
+     * a run whose scenario differs only in those (see readWarmup()). This
+     * relies on no interventions being deployed and no surveys being taken
+     * during the warm-up. */
+    void writeWarmup();
+    /** Load the warm-up snapshot named by --load-warmup, in place of
+     * simulating the warm-up. */
+    void readWarmup();
     //@}
     
+    /** Write wall-clock times per phase to the file named by --phase-times
+     * (if given). times has one entry per phase. */
+    void writePhaseTimes (const vector<double>& times, double outputTime);
+    
     // Data
     SimTime simPeriodEnd;
     SimTime totalSimDuration;
@@ -75,6 +109,11 @@ private:
     
     // Stored so that it can be verified across checkpoints
     util::Checksum cksum;
+    /// Stored so that it can be verified when loading a warm-up snapshot
+    boost::uint64_t warmupCksum;
+    
+    /// Wall-clock time at construction (see util::timer::wallTime())
+    double startTime;
     
     static bool startedFromCheckpoint;
     
@@ -229,10 +229,14 @@ void AnophelesModel::init2 (size_t sIndex, const OM::Population& population, dou
     // NC's non-autonomous model provides two methods for calculating P_df and
     // P_dif; here we assume that P_E is constant.
     double initialP_df = 0.0;
+    
+    // Number of people represented (sum of human weights), as in sums above.
+    double nHosts = 0.0;
 
     for (Population::ConstIter h = population.cbegin(); h != population.cend(); ++h) {
         const OM::Transmission::PerHost& host = h->perHostTransmission;
-        double prod = host.entoAvailabilityFull (humanBase, sIndex, h->age(sim::now()).inYears());
+        nHosts += h->weight();
+        double prod = host.entoAvailabilityFull (humanBase, sIndex, h->age(sim::now()).inYears()) * h->weight();
         leaveSeekingStateRate += prod;
         prod *= host.probMosqBiting(humanBase, sIndex);
         sumPFindBite += prod;
@@ -256,9 +260,8 @@ void AnophelesModel::init2 (size_t sIndex, const OM::Population& population, dou
     // -----  Calculate required S_v based on desired EIR  -----
     // Last parameter is a multiplication factor for S_v/EIR. First we multiply
     // input EIR by meanPopAvail to give us population average EIR instead of
-    // adult average EIR, then we divide by (sumPFindBite/populationSize) to
-    // get S_v.
-    transmission.emergence->init2( initialP_A, initialP_df, population.size() * meanPopAvail / sumPFindBite, transmission );
+    // adult average EIR, then we divide by (sumPFindBite/nHosts) to get S_v.
+    transmission.emergence->init2( initialP_A, initialP_df, nHosts * meanPopAvail / sumPFindBite, transmission );
     
     // All set up to drive simulation from forcedS_v
 }
@@ -294,11 +297,22 @@ void AnophelesModel::deployVectorPopInterv (size_t instance){
 }
 
 
+void AnophelesModel::initPopSums( PopSums& sums )const{
+    // rate at which mosquitoes find hosts or die (i.e. leave host-seeking state
+    sums.leaveSeekingStateRate = mosqSeekingDeathRate;
+    for( vector<util::SimpleDecayingValue>::const_iterator it=seekingDeathRateIntervs.begin();
+        it != seekingDeathRateIntervs.end(); ++it ){
+        sums.leaveSeekingStateRate *= 1.0 + it->current_value( sim::ts0() );
+    }
+    
+    // NC's non-autonomous model provides two methods for calculating P_df and
+    // P_dif; here we assume that P_E is constant.
+    sums.tsP_df = 0.0;
+    sums.tsP_dif.assign( WithinHost::Genotypes::N(), 0.0 );
+}
+
 // Every sim::oneTS() days:
-void AnophelesModel::advancePeriod (const OM::Population& population,
-                                     vector2D<double>& popProbTransmission,
-                                     size_t sIndex,
-                                     bool isDynamic) {
+void AnophelesModel::advancePeriod( PopSums& sums, bool isDynamic ){
     transmission.emergence->update();
     
     /* Largely equations correspond to Nakul Chitnis's model in
@@ -333,33 +347,10 @@ void AnophelesModel::advancePeriod (const OM::Population& population,
 
 
     // -----  Calculate P_A, P_Ai, P_df, P_dif based on human pop  -----
-    
-    // rate at which mosquitoes find hosts or die (i.e. leave host-seeking state
-    double leaveSeekingStateRate = mosqSeekingDeathRate;
-    for( vector<util::SimpleDecayingValue>::const_iterator it=seekingDeathRateIntervs.begin();
-        it != seekingDeathRateIntervs.end(); ++it ){
-        leaveSeekingStateRate *= 1.0 + it->current_value( sim::ts0() );
-    }
-
-    // NC's non-autonomous model provides two methods for calculating P_df and
-    // P_dif; here we assume that P_E is constant.
-    double tsP_df = 0.0;
-    vector<double> tsP_dif( WithinHost::Genotypes::N(), 0.0 );
-    size_t i = 0;
-    for (Population::ConstIter h = population.cbegin(); h != population.cend(); ++h, ++i) {
-        const OM::Transmission::PerHost& host = h->perHostTransmission;
-        //NOTE: calculate availability relative to age at end of time step;
-        // not my preference but consistent with TransmissionModel::getEIR().
-        //TODO: even stranger since popProbTransmission comes from the previous time step
-        double prod = host.entoAvailabilityFull (humanBase, sIndex, h->age(sim::ts1()).inYears());
-        leaveSeekingStateRate += prod;
-        prod *= host.probMosqBiting(humanBase, sIndex)
-                * host.probMosqResting(humanBase, sIndex);
-        tsP_df += prod;
-        for( size_t genotype = 0; genotype < WithinHost::Genotypes::N(); ++genotype ){
-            tsP_dif[genotype] += prod * popProbTransmission.at(i, genotype);
-        }
-    }
+    // (human contributions were summed by addHost())
+    double leaveSeekingStateRate = sums.leaveSeekingStateRate;
+    double tsP_df = sums.tsP_df;
+    vector<double>& tsP_dif = sums.tsP_dif;
 
     for (vector<NHHParams>::const_iterator nhh = nonHumans.begin(); nhh != nonHumans.end(); ++nhh) {
         leaveSeekingStateRate += nhh->entoAvailability;
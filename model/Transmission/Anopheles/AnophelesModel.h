@@ -120,21 +120,55 @@ public:
     
     ///@brief Functions called as part of usual per-time-step operations
     //@{
+    /** Sums over the human population needed by advancePeriod().
+     * 
+     * These are accumulated for all species in a single sweep over the
+     * population (see VectorModel::vectorUpdate()): call initPopSums(), then
+     * addHost() for each human, then advancePeriod(). */
+    struct PopSums{
+        /// Rate at which mosquitoes leave the host-seeking state
+        double leaveSeekingStateRate;
+        /// Sum of α_i * P_B_i * P_C_i (before scaling by P_Ai_base * P_E)
+        double tsP_df;
+        /// As tsP_df, but weighted by probability of transmission per genotype
+        vector<double> tsP_dif;
+    };
+    
+    /** Reset sums for a new time step. Availability starts from the death
+     * rate while seeking (including interventions). */
+    void initPopSums( PopSums& sums )const;
+    
+    /** Add a human's contribution to sums.
+     * 
+     * @param sums Sums for this species
+     * @param host Transmission data of the human
+     * @param sIndex Index of the type of mosquito in per-type/species lists.
+     * @param ageYears Age of the human at the end of the time step
+     * @param probTransmission Probability of transmission to mosquito for
+     *  this human, per parasite genotype (from the previous time step).
+     * @param weight Number of people the human represents (Human::weight())
+     */
+    inline void addHost( PopSums& sums, const OM::Transmission::PerHost& host,
+                         size_t sIndex, double ageYears,
+                         const vector<double>& probTransmission,
+                         double weight )const
+    {
+        double prod = host.entoAvailabilityFull (humanBase, sIndex, ageYears) * weight;
+        sums.leaveSeekingStateRate += prod;
+        prod *= host.probMosqBiting(humanBase, sIndex)
+                * host.probMosqResting(humanBase, sIndex);
+        sums.tsP_df += prod;
+        for( size_t genotype = 0; genotype < probTransmission.size(); ++genotype ){
+            sums.tsP_dif[genotype] += prod * probTransmission[genotype];
+        }
+    }
+    
     /** Called per time-step. Does most of calculation of EIR.
      *
-     * @param population The human population; so we can sum up availability and
-     *  infectiousness.
-     * @param popProbTransmission A two-dimensional vector of the probability
-     *  of transmission to mosquito for each human host (first index, in same
-     *  order as population) and for each parasite genotype (second index).
-     *  This is simply a cache, since calling probTransmissionToMosquito() is
-     *  expensive.
-     * @param sIndex Index of the type of mosquito in per-type/species lists.
+     * @param sums Sums over the human population, accumulated by addHost().
      * @param isDynamic True to use full model; false to drive model from current contents of S_v.
      */
-    void advancePeriod( const OM::Population& population,
-                        vector2D<double>& popProbTransmission,
-                        size_t sIndex, bool isDynamic );
+    void advancePeriod( PopSums& sums, bool isDynamic );
 
     /** Returns the EIR calculated by advancePeriod().
      *
@@ -195,8 +229,8 @@ public:
         mosqSeekingDuration & stream;
         probMosqSurvivalOvipositing & stream;
         transmission & stream;
-        seekingDeathRateIntervs & stream;
-        probDeathOvipositingIntervs & stream;
+        util::checkpoint::checkpointKeepSize( seekingDeathRateIntervs, stream );
+        util::checkpoint::checkpointKeepSize( probDeathOvipositingIntervs, stream );
         partialEIR & stream;
     }
 
@@ -130,7 +130,7 @@ public:
         forcedS_v & stream;
         initNvFromSv & stream;
         initOvFromSv & stream;
-        emergenceReduction & stream;
+        util::checkpoint::checkpointKeepSize( emergenceReduction, stream );
         emergenceSurvival & stream;
         checkpoint (stream);
     }
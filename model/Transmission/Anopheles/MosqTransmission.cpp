@@ -27,6 +27,8 @@
 #include "util/errors.h"
 #include "util/ModelOptions.h"
 #include "util/StreamValidator.h"
+#include "util/parallel.h"
+#include "util/CommandLine.h"
 #include "schema/entomology.h"
 
 namespace OM {
@@ -35,6 +37,14 @@ namespace Anopheles {
 using namespace OM::util;
 using WithinHost::Genotypes;
 
+/** Genotypes are updated concurrently (when several threads are in use and
+ * species are not already being updated in parallel) only when there are at
+ * least this many; otherwise threading overhead dominates. */
+const int minParallelGenotypes = 16;
+
+// use updateGenotypesVector instead of updateGenotypesScalar
+static bool vector_kernel = false;
+
 // -----  Initialisation of model, done before human warmup  ------
 
 MosqTransmission::MosqTransmission() :
@@ -53,6 +63,8 @@ MosqTransmission::MosqTransmission() :
 void MosqTransmission::initialise ( const scnXml::AnophelesParams::LifeCycleOptional& lcOpt,
                                     const scnXml::AnophelesParams::SimpleMPDOptional& simpleMPDOpt,
                                     const scnXml::Mosq& mosq ) {
+    setVectorKernel( util::CommandLine::option( util::CommandLine::VECTOR_GENOTYPES ) );
+    
     if (util::ModelOptions::option( util::VECTOR_LIFE_CYCLE_MODEL )){
         throw util::xml_scenario_error("VECTOR_LIFE_CYCLE_MODEL not yet "
             "implemented. Use VECTOR_SIMPLE_MPD_MODEL instead.");
@@ -138,7 +150,7 @@ void MosqTransmission::initState ( double tsP_A, double tsP_df,
 
 
 void MosqTransmission::update( SimTime d0, double tsP_A, double tsP_df,
-        const vector<double> tsP_dif, bool isDynamic,
+        const vector<double>& tsP_dif, bool isDynamic,
         vector<double>& partialEIR, double EIR_factor )
 {
     SimTime d1 = d0 + sim::oneDay();    // end of step
@@ -198,8 +210,59 @@ void MosqTransmission::update( SimTime d0, double tsP_A, double tsP_df,
     }
     //END cache calculation: fArray, ftauArray, uninfected_v
     
+    if( vector_kernel ){
+        updateGenotypesVector( d1Mod, t0, t1, ttau, isDynamic, partialEIR, EIR_factor );
+    }else{
+        updateGenotypesScalar( d1Mod, t0, t1, ttau, isDynamic, partialEIR, EIR_factor );
+    }
+    
+    // Summed here in genotype order so that results don't depend on threading.
     double total_S_v = 0.0;
     for( size_t genotype = 0; genotype < Genotypes::N(); ++genotype ){
+        total_S_v += S_v.at(t1, genotype);
+    }
+    
+    const double nOvipositing = P_df[ttau] * N_v[ttau];       // number ovipositing on this step
+    const double newAdults = emergence->update( d0, nOvipositing, total_S_v );
+    util::streamValidate( newAdults );
+    
+    // num seeking mosquitos is: new adults + those which didn't find a host
+    // yesterday + those who found a host tau days ago and survived cycle:
+    N_v[t1] = newAdults
+                + P_A[t0]  * N_v[t0]
+                + nOvipositing;
+    
+    timeStep_N_v0 += newAdults;
+    
+//     if( printDebug ){
+//         cerr<<"step ending "<<d1<<" (days):\temergence "<<newAdults<<",\tN_v "<<N_v[t1]<<",\tS_v "<<total_S_v<<endl;
+        //cerr << "len: "<<N_v_length<<"\td1Mod: "<<d1Mod<<"\tt(0,1): "<<t0<<" "<<t1<<" "<<ttau<<endl;
+/*        cerr<<"P_A\t"<<P_A[t0]<<"\t"<<P_A[t1]<<"\t"<<P_A[ttau]<<endl;
+        cerr<<"P_df\t"<<P_df[t0]<<"\t"<<P_df[t1]<<"\t"<<P_df[ttau]<<endl;
+        cerr<<"P_dif\t"<<P_dif[t0]<<"\t"<<P_dif[t1]<<"\t"<<P_dif[ttau]<<endl;*/
+//         cerr<<ftauArray<<endl;
+//         cerr<<fArray<<endl;
+//     }
+}
+
+
+void MosqTransmission::setVectorKernel( bool vectorKernel ){
+    vector_kernel = vectorKernel;
+}
+
+void MosqTransmission::updateGenotypesScalar( SimTime d1Mod, SimTime t0,
+        SimTime t1, SimTime ttau, bool isDynamic,
+        vector<double>& partialEIR, double EIR_factor )
+{
+    // Genotypes are independent here, so they may be updated concurrently.
+    // When called from within VectorModel's per-species parallel region,
+    // nested parallelism is disabled (see util::parallel::init()) and this
+    // runs on the calling thread.
+    const int nGenotypes = static_cast<int>(Genotypes::N());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if( nGenotypes >= minParallelGenotypes && util::parallel::numThreads() > 1 )
+#endif
+    for( int genotype = 0; genotype < nGenotypes; ++genotype ){
         // Num infected seeking mosquitoes is the new ones (those who were
         // uninfected tau days ago, started a feeding cycle then, survived and
         // got infected) + those who didn't find a host yesterday + those who
@@ -239,31 +302,65 @@ void MosqTransmission::update( SimTime d0, double tsP_A, double tsP_df,
         }
         
         partialEIR[genotype] += S_v.at(t1, genotype) * EIR_factor;
-        total_S_v += S_v.at(t1, genotype);
         //END S_v
     }
+}
+
+void MosqTransmission::updateGenotypesVector( SimTime d1Mod, SimTime t0,
+        SimTime t1, SimTime ttau, bool isDynamic,
+        vector<double>& partialEIR, double EIR_factor )
+{
+    // Rows of P_dif, O_v and S_v (one day, all genotypes) are contiguous, so
+    // each equation is applied a row at a time. Factors not depending on the
+    // genotype are multiplied out first.
+    const size_t nGenotypes = Genotypes::N();
+    const double pA0 = P_A[t0];
+    const double pdfTau = P_df[ttau];
     
-    const double nOvipositing = P_df[ttau] * N_v[ttau];       // number ovipositing on this step
-    const double newAdults = emergence->update( d0, nOvipositing, total_S_v );
-    util::streamValidate( newAdults );
+    // O_v (as in updateGenotypesScalar)
+    {
+        const double uninfTau = uninfected_v[mosqRestDuration];
+        const double *pdif = &P_dif.at(ttau,0);
+        const double *o0 = &O_v.at(t0,0), *oTau = &O_v.at(ttau,0);
+        double *o1 = &O_v.at(t1,0);
+        for( size_t g = 0; g < nGenotypes; ++g ){
+            o1[g] = pdif[g] * uninfTau + pA0 * o0[g] + pdfTau * oTau[g];
+        }
+    }
     
-    // num seeking mosquitos is: new adults + those which didn't find a host
-    // yesterday + those who found a host tau days ago and survived cycle:
-    N_v[t1] = newAdults
-                + P_A[t0]  * N_v[t0]
-                + nOvipositing;
+    // S_v: the sum over l of P_dif(d1-θ_s-l) weighted by genotype-independent
+    // factors, accumulated a row at a time into svSum
+    const SimTime ts = d1Mod - EIPDuration;
+    svSum.assign( nGenotypes, 0.0 );
+    double *sum = &svSum[0];
+    for( SimTime l = sim::oneDay(); l < mosqRestDuration; l += sim::oneDay() ){
+        const double w = pdfTau * uninfected_v[EIPDuration+l] *
+                ftauArray[EIPDuration+l-mosqRestDuration];
+        const double *pdif = &P_dif.at(mod_nn(ts - l, N_v_length),0);
+        for( size_t g = 0; g < nGenotypes; ++g ){
+            sum[g] += pdif[g] * w;
+        }
+    }
     
-    timeStep_N_v0 += newAdults;
+    const double w0 = fArray[EIPDuration-mosqRestDuration] * uninfected_v[EIPDuration];
+    const double *pdif = &P_dif.at(mod_nn(ts, N_v_length),0);
+    const double *s0 = &S_v.at(t0,0), *sTau = &S_v.at(ttau,0);
+    double *s1 = &S_v.at(t1,0);
+    for( size_t g = 0; g < nGenotypes; ++g ){
+        s1[g] = pdif[g] * w0 + sum[g] + pA0 * s0[g] + pdfTau * sTau[g];
+    }
     
-//     if( printDebug ){
-//         cerr<<"step ending "<<d1<<" (days):\temergence "<<newAdults<<",\tN_v "<<N_v[t1]<<",\tS_v "<<total_S_v<<endl;
-        //cerr << "len: "<<N_v_length<<"\td1Mod: "<<d1Mod<<"\tt(0,1): "<<t0<<" "<<t1<<" "<<ttau<<endl;
-/*        cerr<<"P_A\t"<<P_A[t0]<<"\t"<<P_A[t1]<<"\t"<<P_A[ttau]<<endl;
-        cerr<<"P_df\t"<<P_df[t0]<<"\t"<<P_df[t1]<<"\t"<<P_df[ttau]<<endl;
-        cerr<<"P_dif\t"<<P_dif[t0]<<"\t"<<P_dif[t1]<<"\t"<<P_dif[ttau]<<endl;*/
-//         cerr<<ftauArray<<endl;
-//         cerr<<fArray<<endl;
-//     }
+    if( isDynamic ){
+        // infectious mosquito cut-off; see updateGenotypesScalar
+        for( size_t g = 0; g < nGenotypes; ++g ){
+            s1[g] = s1[g] <= minInfectedThreshold ? 0.0 : s1[g];
+        }
+    }
+    
+    double *eir = &partialEIR[0];
+    for( size_t g = 0; g < nGenotypes; ++g ){
+        eir[g] += s1[g] * EIR_factor;
+    }
 }
 
 
@@ -29,6 +29,7 @@
 #include <boost/shared_ptr.hpp>
 
 class MosqLifeCycleSuite;
+class MosqTransmissionSuite;
 
 namespace OM {
 namespace Transmission {
@@ -84,9 +85,18 @@ public:
      * @param EIR_factor see parameter partialEIR
      */
     void update( SimTime d0, double tsP_A, double tsP_df,
-                   const vector<double> tsP_dif, bool isDynamic,
+                   const vector<double>& tsP_dif, bool isDynamic,
                    vector<double>& partialEIR, double EIR_factor );
     
+    /** Select the implementation of the per-genotype part of update() (O_v,
+     * S_v and partialEIR). The default scalar kernel evaluates the equations
+     * genotype by genotype. The vector kernel works on whole rows of
+     * genotypes in loops which compilers can vectorise, and multiplies out
+     * factors which don't depend on the genotype first; since products are
+     * evaluated in a different order, results agree with those of the
+     * scalar kernel only to rounding error. */
+    static void setVectorKernel( bool vectorKernel );
+    
     ///@brief Interventions and reporting
     //@{
     void uninfectVectors();
@@ -252,10 +262,25 @@ private:
     vecDay<double> uninfected_v;
     //@}
     
+    /** Working memory for updateGenotypesVector(): the sum over days in the
+     * S_v equation, per genotype. Not checkpointed. */
+    vector<double> svSum;
+    
     /** Variables tracking data to be reported. */
     double timeStep_N_v0;
     
+    /** Per-genotype update of O_v, S_v and partialEIR for the day ending
+     * at d1Mod (mod N_v_length), given cached fArray, ftauArray and
+     * uninfected_v; see setVectorKernel(). */
+    void updateGenotypesScalar( SimTime d1Mod, SimTime t0, SimTime t1,
+            SimTime ttau, bool isDynamic, vector<double>& partialEIR,
+            double EIR_factor );
+    void updateGenotypesVector( SimTime d1Mod, SimTime t0, SimTime t1,
+            SimTime ttau, bool isDynamic, vector<double>& partialEIR,
+            double EIR_factor );    ///< ditto
+    
     friend class ::MosqLifeCycleSuite;
+    friend class ::MosqTransmissionSuite;
 };
 
 }
@@ -52,17 +52,20 @@ void PerHost::initialise (TransmissionModel& tm, double availabilityFactor) {
         for (size_t i = 0; i < vTM->numSpecies; ++i)
             species[i].initialise (vTM->species[i].getHumanBaseParams(), availabilityFactor);
     }
+    itvCache.assign( species.size(), SpeciesFactors() );
 }
 
 void PerHost::update(Host::Human& human){
     for( ListActiveComponents::iterator it = activeComponents.begin(); it != activeComponents.end(); ++it ){
         it->update(human);
     }
+    invalidateItvCache();
 }
 
 void PerHost::deployComponent( const HumanVectorInterventionComponent& params ){
     // This adds per-host per-intervention details to the host's data set.
     // This data is never removed since it can contain per-host heterogeneity samples.
+    invalidateItvCache();
     for( ListActiveComponents::iterator it = activeComponents.begin(); it != activeComponents.end(); ++it ){
         if( it->id() == params.id() ){
             // already have a deployment for that description; just update it
@@ -74,28 +77,35 @@ void PerHost::deployComponent( const HumanVectorInterventionComponent& params ){
     activeComponents.push_back( params.makeHumanPart() );
 }
 
+void PerHost::invalidateItvCache(){
+    for( vector<SpeciesFactors>::iterator it = itvCache.begin(); it != itvCache.end(); ++it ){
+        it->availability.time = sim::never();
+        it->probBiting.time = sim::never();
+        it->probResting.time = sim::never();
+    }
+}
+
 
 // Note: in the case an intervention is not present, we can use the approximation
 // of Weibull decay over the time span now - sim::never()
 // (easily large enough for conceivable Weibull params that the value is 0.0 when
 // rounded to a double. Performance-wise it's perhaps slightly slower than using
 // an if() when interventions aren't present.
-double PerHost::entoAvailabilityHetVecItv (const Anopheles::PerHostBase& base,
-                                size_t speciesIndex) const {
+double PerHost::calcEntoAvailabilityHetVecItv (size_t speciesIndex) const {
     double alpha_i = species[speciesIndex].getEntoAvailability();
     for( ListActiveComponents::const_iterator it = activeComponents.begin(); it != activeComponents.end(); ++it ){
         alpha_i *= it->relativeAttractiveness( speciesIndex );
     }
     return alpha_i;
 }
-double PerHost::probMosqBiting (const Anopheles::PerHostBase& base, size_t speciesIndex) const {
+double PerHost::calcProbMosqBiting (size_t speciesIndex) const {
     double P_B_i = species[speciesIndex].getProbMosqBiting();
     for( ListActiveComponents::const_iterator it = activeComponents.begin(); it != activeComponents.end(); ++it ){
         P_B_i *= it->preprandialSurvivalFactor( speciesIndex );
     }
     return P_B_i;
 }
-double PerHost::probMosqResting (const Anopheles::PerHostBase& base, size_t speciesIndex) const {
+double PerHost::calcProbMosqResting (size_t speciesIndex) const {
     double pRest = species[speciesIndex].getProbMosqRest();
     for( ListActiveComponents::const_iterator it = activeComponents.begin(); it != activeComponents.end(); ++it ){
         pRest *= it->postprandialSurvivalFactor( speciesIndex );
@@ -120,6 +130,7 @@ void PerHost::checkpointIntervs( ostream& stream ){
     }
 }
 void PerHost::checkpointIntervs( istream& stream ){
+    itvCache.assign( species.size(), SpeciesFactors() );
     size_t l;
     l & stream;
     validateListSize(l);
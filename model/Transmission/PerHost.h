@@ -131,7 +131,8 @@ public:
     void initialise (TransmissionModel& tm, double availabilityFactor);
     //@}
     
-    /// Call once per time step. Updates net holes.
+    /** Call once per time step. Updates net holes, then caches the per-species
+     * effects of interventions for this time step. */
     void update(Host::Human& human);
     
     ///@brief Intervention controls
@@ -197,7 +198,14 @@ public:
      * rate factors.)
      * 
      * Assume mean is human-to-vector availability rate factor. */
-    double entoAvailabilityHetVecItv( const Anopheles::PerHostBase& base, size_t speciesIndex ) const;
+    inline double entoAvailabilityHetVecItv( const Anopheles::PerHostBase& base, size_t speciesIndex ) const{
+        CachedFactor& c = itvCache[speciesIndex].availability;
+        if( c.time != sim::nowOrTs1() ){
+            c.value = calcEntoAvailabilityHetVecItv( speciesIndex );
+            c.time = sim::nowOrTs1();
+        }
+        return c.value;
+    }
     
     /** Availability rate of human to mosquitoes (α_i). Equals 
      * entoAvailabilityHetVecItv()*getRelativeAvailability().
@@ -219,10 +227,24 @@ public:
     ///@brief Get killing effects of interventions pre/post biting
     //@{
     /** Probability of a mosquito succesfully biting a host (P_B_i). */
-    double probMosqBiting (const Anopheles::PerHostBase& base, size_t speciesIndex) const;
+    inline double probMosqBiting (const Anopheles::PerHostBase& base, size_t speciesIndex) const{
+        CachedFactor& c = itvCache[speciesIndex].probBiting;
+        if( c.time != sim::nowOrTs1() ){
+            c.value = calcProbMosqBiting( speciesIndex );
+            c.time = sim::nowOrTs1();
+        }
+        return c.value;
+    }
     /** Probability of a mosquito succesfully finding a resting
      * place after biting and then resting (P_C_i * P_D_i). */
-    double probMosqResting (const Anopheles::PerHostBase& base, size_t speciesIndex) const;
+    inline double probMosqResting (const Anopheles::PerHostBase& base, size_t speciesIndex) const{
+        CachedFactor& c = itvCache[speciesIndex].probResting;
+        if( c.time != sim::nowOrTs1() ){
+            c.value = calcProbMosqResting( speciesIndex );
+            c.time = sim::nowOrTs1();
+        }
+        return c.value;
+    }
     /** Set true to remove human from transmission. Must set back to false
      * to restore transmission. */
     //@}
@@ -255,6 +277,12 @@ private:
     void checkpointIntervs( ostream& stream );
     void checkpointIntervs( istream& stream );
     
+    // Uncached versions of entoAvailabilityHetVecItv, probMosqBiting and
+    // probMosqResting: these walk activeComponents.
+    double calcEntoAvailabilityHetVecItv( size_t speciesIndex ) const;
+    double calcProbMosqBiting( size_t speciesIndex ) const;
+    double calcProbMosqResting( size_t speciesIndex ) const;
+    
     vector<Anopheles::PerHost> species;
     
     // Determines whether human is outside transmission
@@ -267,6 +295,26 @@ private:
     typedef boost::ptr_list<PerHostInterventionData> ListActiveComponents;
     ListActiveComponents activeComponents;
     
+    /* Values of entoAvailabilityHetVecItv, probMosqBiting and probMosqResting
+     * per species, each computed on first use and valid while its time equals
+     * sim::nowOrTs1(). Intervention state changes only in update() and
+     * deployComponent(), which invalidate the cache; thus
+     * VectorModel::vectorUpdate() (before humans are updated) and
+     * calculateEIR() (after) each see current values, and monitoring after
+     * the update reuses those from calculateEIR(). Values nothing reads (e.g.
+     * while the EIR is forced) are never computed. A human is only used by
+     * one thread at a time. Not checkpointed. */
+    struct CachedFactor {
+        CachedFactor() : value(0.0), time(sim::never()) {}
+        double value;
+        SimTime time;
+    };
+    struct SpeciesFactors {
+        CachedFactor availability, probBiting, probResting;
+    };
+    void invalidateItvCache();
+    mutable vector<SpeciesFactors> itvCache;
+    
     static AgeGroupInterpolator relAvailAge;
 };
 
@@ -33,6 +33,7 @@
 #include "util/CommandLine.h"
 #include "util/vectors.h"
 #include "util/ModelOptions.h"
+#include "util/parallel.h"
 
 #include <cmath>
 #include <cfloat>
@@ -128,6 +129,10 @@ TransmissionModel::TransmissionModel(const scnXml::Entomology& entoData,
 {
     initialisationEIR.assign (sim::stepsPerYear(), 0.0);
     surveyInoculations.assign(survInocsSize(nGenotypes), 0.0);
+    threadAccumulators.resize( util::parallel::numThreads() - 1 );
+    for( size_t t = 0; t < threadAccumulators.size(); ++t ){
+        threadAccumulators[t].surveyInoculations = surveyInoculations;
+    }
     
   using Monitoring::Continuous;
   Continuous.registerCallback( "input EIR", "\tinput EIR", MakeDelegate( this, &TransmissionModel::ctsCbInputEIR ) );
@@ -140,24 +145,51 @@ TransmissionModel::~TransmissionModel () {
 }
 
 
+void TransmissionModel::mergeThreadAccumulators(){
+    for( size_t t = 0; t < threadAccumulators.size(); ++t ){
+        ThreadAccumulators& acc = threadAccumulators[t];
+        tsAdultEntoInocs += acc.tsAdultEntoInocs;
+        tsNumAdults += acc.tsNumAdults;
+        for( size_t i = 0; i < surveyInoculations.size(); ++i ){
+            surveyInoculations[i] += acc.surveyInoculations[i];
+        }
+        acc.tsAdultEntoInocs = 0.0;
+        acc.tsNumAdults = 0;
+        acc.surveyInoculations.assign( acc.surveyInoculations.size(), 0.0 );
+    }
+}
+
+void TransmissionModel::updateInfectiousness (const Population& population, bool withSumX) {
+    popInfectiousness.resize( population.size() );
+    popSumX.resize( withSumX ? population.size() : 0 );
+    size_t i = 0;
+    for (Population::ConstIter h = population.cbegin(); h != population.cend(); ++h, ++i) {
+        const double tbvFactor = h->getVaccine().getFactor( interventions::Vaccine::TBV );
+        popInfectiousness[i] = h->withinHostModel->probTransmissionToMosquito(
+            tbvFactor, withSumX ? &popSumX[i] : 0 );
+    }
+}
+
 double TransmissionModel::updateKappa (const Population& population) {
+    mergeThreadAccumulators();
+    updateInfectiousness( population, false );
+    
     // We calculate kappa for output and the non-vector model.
     double sumWt_kappa= 0.0;
     double sumWeight  = 0.0;
     numTransmittingHumans = 0;
 
-    for (Population::ConstIter h = population.cbegin(); h != population.cend(); ++h) {
+    size_t i = 0;
+    for (Population::ConstIter h = population.cbegin(); h != population.cend(); ++h, ++i) {
         //NOTE: calculate availability relative to age at end of time step;
         // not my preference but consistent with TransmissionModel::getEIR().
         const double avail = h->perHostTransmission.relativeAvailabilityHetAge(
-            h->age(sim::ts1()).inYears());
+            h->age(sim::ts1()).inYears()) * h->weight();
         sumWeight += avail;
-        const double tbvFactor = h->getVaccine().getFactor( interventions::Vaccine::TBV );
-        const double pTransmit = h->withinHostModel->probTransmissionToMosquito( tbvFactor, 0 );
-        const double riskTrans = avail * pTransmit;
+        const double riskTrans = avail * popInfectiousness[i];
         sumWt_kappa += riskTrans;
         if( riskTrans > 0.0 )
-            ++numTransmittingHumans;
+            numTransmittingHumans += h->weight();
     }
 
 
@@ -202,15 +234,25 @@ double TransmissionModel::getEIR( Host::Human& human, SimTime age,
     calculateEIR( human, ageYears, EIR );
     util::streamValidate( EIR );
     
+    const size_t thread = util::parallel::threadIndex();
+    vector<double>& inocs = thread == 0 ? surveyInoculations :
+        threadAccumulators[thread-1].surveyInoculations;
+    // Reports count all people the human represents.
+    const uint32_t weight = human.weight();
     for( size_t g = 0, nG = EIR.size(); g < nG; ++g ){
         size_t index = survInocsIndex(human.monAgeGroup().i(), human.cohortSet(), g);
-        surveyInoculations[index] += EIR[g];
+        inocs[index] += EIR[g] * weight;
     }
     
     double allEIR = vectors::sum( EIR );
     if( age >= adultAge ){
-        tsAdultEntoInocs += allEIR;
-        tsNumAdults += 1;
+        if( thread == 0 ){
+            tsAdultEntoInocs += allEIR * weight;
+            tsNumAdults += weight;
+        }else{
+            threadAccumulators[thread-1].tsAdultEntoInocs += allEIR * weight;
+            threadAccumulators[thread-1].tsNumAdults += weight;
+        }
     }
     return allEIR;
 }
@@ -264,7 +306,8 @@ void TransmissionModel::checkpoint (istream& stream) {
     lastSurveyTime & stream;
     numTransmittingHumans & stream;
     tsNumAdults & stream;
-    surveyInoculations & stream;
+    // length depends on monitoring, which may differ when loading a warm-up snapshot
+    util::checkpoint::checkpointKeepSize( surveyInoculations, stream );
 }
 void TransmissionModel::checkpoint (ostream& stream) {
     simulationMode & stream;
@@ -216,10 +216,27 @@ protected:
    * human infectiousness weighted by availability to mosquitoes). */
   double updateKappa (const Population& population);
   
+  /** Set popInfectiousness (and popSumX if withSumX) from
+   * probTransmissionToMosquito() for each human, in population order.
+   * 
+   * Called by each user: the population and transmission-blocking vaccine
+   * factors may change between the vector update and updateKappa(), while
+   * the within-host models cache the remainder of the calculation. */
+  void updateInfectiousness (const Population& population, bool withSumX);
+  
+  /** Per-human probability of infecting a biting mosquito (including the
+   * effect of transmission-blocking vaccines) and sumX output of
+   * probTransmissionToMosquito(), as set by updateInfectiousness().
+   * Not checkpointed. */
+  vector<double> popInfectiousness, popSumX;
+  
   virtual void checkpoint (istream& stream);
   virtual void checkpoint (ostream& stream);
   
 private:
+    /// Add accumulators of threads other than the first into the main ones.
+    void mergeThreadAccumulators();
+    
     void ctsCbInputEIR (ostream& stream);
     void ctsCbSimulatedEIR (ostream& stream);
     void ctsCbKappa (ostream& stream);
@@ -304,6 +321,17 @@ private:
     /// Total inoculations since last survey (multidimensional).
     /// See survInocsSize, survInocsIndex in cpp file.
     vector<double> surveyInoculations;
+    
+    /** Accumulators used by getEIR() from threads 1, 2, ... when humans are
+     * updated in parallel (thread 0 uses the above). Merged by updateKappa();
+     * not checkpointed (always zero between updates). */
+    struct ThreadAccumulators{
+        ThreadAccumulators() : tsAdultEntoInocs(0.0), tsNumAdults(0) {}
+        double tsAdultEntoInocs;
+        int tsNumAdults;
+        vector<double> surveyInoculations;
+    };
+    vector<ThreadAccumulators> threadAccumulators;
 };
 
 } }
@@ -27,6 +27,9 @@
 #include "util/vectors.h"
 #include "util/ModelOptions.h"
 #include "util/SpeciesIndexChecker.h"
+#include "util/parallel.h"
+#include "util/profile.h"
+#include "util/errors.h"
 
 #include <fstream>
 #include <map>
@@ -39,11 +42,13 @@ using namespace OM::util;
 
 double VectorModel::meanPopAvail (const Population& population) {
     double sumRelativeAvailability = 0.0;
+    double nHosts = 0.0;        // people represented (see Human::weight())
     for (Population::ConstIter h = population.cbegin(); h != population.cend(); ++h){
-        sumRelativeAvailability += h->perHostTransmission.relativeAvailabilityAge (h->age(sim::now()).inYears());
+        sumRelativeAvailability += h->perHostTransmission.relativeAvailabilityAge (h->age(sim::now()).inYears()) * h->weight();
+        nHosts += h->weight();
     }
-    if( population.size() > 0 ){
-        return sumRelativeAvailability / population.size();     // mean-rel-avail
+    if( nHosts > 0.0 ){
+        return sumRelativeAvailability / nHosts;     // mean-rel-avail
     }else{
         // value should be unimportant when no humans are available, though inf/nan is not acceptable
         return 1.0;
@@ -376,23 +381,73 @@ double VectorModel::calculateEIR(Host::Human& human, double ageYears,
 
 // Every Global::interval days:
 void VectorModel::vectorUpdate (const Population& population) {
-    vector2D<double> popProbTransmission;
-    popProbTransmission.resize( population.size(), WithinHost::Genotypes::N() );
+    util::profile::Scope profileScope( util::profile::VECTOR_UPDATE );
+    
+    // All per-host quantities needed by each species are summed in a single
+    // pass over the population.
+    popSums.resize( numSpecies );
+    for (size_t s = 0; s < numSpecies; ++s){
+        species[s].initPopSums( popSums[s] );
+    }
+    
+    const size_t nGenotypes = WithinHost::Genotypes::N();
+    updateInfectiousness( population, nGenotypes > 1 );
+    vector<double> probTransmission( nGenotypes );
     size_t i = 0;
     for( Population::ConstIter h = population.cbegin(); h != population.cend(); ++h, ++i ){
-        const double tbvFac = h->getVaccine().getFactor( interventions::Vaccine::TBV );
-        WithinHost::WHInterface& whm = *h->withinHostModel;
-        double sumX;
-        const double pTrans = whm.probTransmissionToMosquito( tbvFac, &sumX );
-        if( WithinHost::Genotypes::N() == 1 ) popProbTransmission.at(i,0) = pTrans;
-        else for( size_t g = 0; g < WithinHost::Genotypes::N(); ++g ){
-            const double k = whm.probTransGenotype( pTrans, sumX, g );
+        const Host::Human& human = *h;
+        const double pTrans = popInfectiousness[i];
+        if( nGenotypes == 1 ) probTransmission[0] = pTrans;
+        else for( size_t g = 0; g < nGenotypes; ++g ){
+            const double k = human.withinHostModel->probTransGenotype( pTrans, popSumX[i], g );
             assert( (boost::math::isfinite)(k) );
-            popProbTransmission.at(i,g) = k;
+            probTransmission[g] = k;
+        }
+        
+        //NOTE: calculate availability relative to age at end of time step;
+        // not my preference but consistent with TransmissionModel::getEIR().
+        //TODO: even stranger since probTransmission comes from the previous time step
+        const double ageYears = (sim::ts1() - population.dateOfBirth(i)).inYears();
+        const PerHost& host = human.perHostTransmission;
+        const double weight = human.weight();
+        for (size_t s = 0; s < numSpecies; ++s){
+            species[s].addHost( popSums[s], host, s, ageYears, probTransmission, weight );
         }
     }
-    for (size_t i = 0; i < numSpecies; ++i){
-        species[i].advancePeriod (population, popProbTransmission, i, simulationMode == dynamicEIR);
+    
+    advanceSpecies();
+}
+void VectorModel::advanceSpecies () {
+    // Species are independent once the population sums are known, so with
+    // several threads they are advanced concurrently. Each species writes only
+    // its own state (including partialEIR, summed over species per human in
+    // species order by calculateEIR()), so results don't depend on threading.
+    // Exceptions may not leave a parallel region; the first (by species
+    // index) is recorded and thrown afterwards.
+    const bool isDynamic = simulationMode == dynamicEIR;
+    const int nSpecies = static_cast<int>(numSpecies);
+    vector<string> errMsg( numSpecies );
+    vector<int> errCode( numSpecies, util::Error::None );
+    
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if( nSpecies > 1 && util::parallel::numThreads() > 1 )
+#endif
+    for( int s = 0; s < nSpecies; ++s ){
+        try{
+            species[s].advancePeriod (popSums[s], isDynamic);
+        }catch( const util::base_exception& e ){
+            errMsg[s] = e.message();
+            errCode[s] = e.getCode();
+        }catch( const std::exception& e ){
+            errMsg[s] = e.what();
+            errCode[s] = util::Error::Default;
+        }
+    }
+    
+    for( size_t s = 0; s < numSpecies; ++s ){
+        if( errCode[s] != util::Error::None ){
+            throw util::base_exception( errMsg[s], errCode[s] );
+        }
     }
 }
 void VectorModel::update( const Population& population ) {
@@ -76,6 +76,10 @@ private:
     /** Return the mean availability of human population to mosquitoes. */
     static double meanPopAvail (const Population& population);
     
+    /** Call advancePeriod() on each species, using popSums (threaded when
+     * more than one thread is in use). */
+    void advanceSpecies ();
+    
   void ctsCbN_v0 (ostream& stream);
   void ctsCbP_A (ostream& stream);
   void ctsCbP_df (ostream& stream);
@@ -122,6 +126,10 @@ private:
   map<string,size_t> speciesIndex;
   //@}
   
+  /// Per-species sums over the population, used by vectorUpdate(). Not
+  /// checkpointed (recalculated each time step).
+  vector<AnophelesModel::PopSums> popSums;
+  
   friend class PerHost;
   friend class AnophelesModelSuite;
 };
@@ -26,6 +26,7 @@
 #include "PopulationStats.h"
 #include "util/AgeGroupInterpolation.h"
 #include "util/random.h"
+#include "util/profile.h"
 #include "util/StreamValidator.h"
 #include "schema/scenario.h"
 
@@ -67,6 +68,7 @@ void CommonWithinHost::init( const scnXml::Scenario& scenario ){
         mon::isUsedM(mon::MHF_LOG_DENSITY_GENOTYPE);
     
     PkPd::LSTMModel::init( scenario );
+    CommonInfection::initPool();
 }
 
 CommonWithinHost::CommonWithinHost( double comorbidityFactor ) :
@@ -88,8 +90,8 @@ CommonWithinHost::CommonWithinHost( double comorbidityFactor ) :
 }
 
 CommonWithinHost::~CommonWithinHost() {
-    for( list<CommonInfection*>::iterator inf = infections.begin(); inf != infections.end(); ++inf ){
-        delete *inf;
+    for( size_t i = 0; i < infections.size(); ++i ){
+        delete infections[i];
     }
     infections.clear();
 }
@@ -97,17 +99,21 @@ CommonWithinHost::~CommonWithinHost() {
 // -----  Simple infection adders/removers  -----
 
 void CommonWithinHost::clearInfections( Treatments::Stages stage ){
-    for (std::list<CommonInfection*>::iterator inf = infections.begin(); inf != infections.end();) {
+    size_t kept = 0;    // infections kept are moved to the front, in order
+    for( size_t i = 0; i < infections.size(); ++i ){
+        CommonInfection* inf = infections[i];
         if( stage == Treatments::BOTH ||
-            (stage == Treatments::LIVER && !(*inf)->bloodStage()) ||
-            (stage == Treatments::BLOOD && (*inf)->bloodStage())
+            (stage == Treatments::LIVER && !inf->bloodStage()) ||
+            (stage == Treatments::BLOOD && inf->bloodStage())
         ){
-            delete *inf;
-            inf = infections.erase( inf );
+            delete inf;
+            util::profile::count( util::profile::INFECTIONS_CLEARED );
         }else{
-            ++inf;
+            infections[kept] = inf;
+            ++kept;
         }
     }
+    infections.resize( kept );
     numInfs = infections.size();
 }
 
@@ -118,22 +124,23 @@ void CommonWithinHost::treatPkPd(size_t schedule, size_t dosages, double age){
     pkpdModel.prescribe( schedule, dosages, age, mass );
 }
 void CommonWithinHost::clearImmunity() {
-    for (std::list<CommonInfection*>::iterator inf = infections.begin(); inf != infections.end(); ++inf) {
-        (*inf)->clearImmunity();
+    for( size_t i = 0; i < infections.size(); ++i ){
+        infections[i]->clearImmunity();
     }
     m_cumulative_h = 0.0;
     m_cumulative_Y_lag = 0.0;
 }
 void CommonWithinHost::importInfection(){
-    PopulationStats::totalInfections += 1;
-    if( numInfs < MAX_INFECTIONS ){
-        PopulationStats::allowedInfections += 1;
+    const bool allowed = numInfs < MAX_INFECTIONS;
+    PopulationStats::addInfections( 1, allowed ? 1 : 0 );
+    if( allowed ){
         m_cumulative_h += 1;
         numInfs += 1;
         // This is a hook, used by interventions. The newly imported infections
         // should use initial frequencies to select genotypes.
         vector<double> weights( 0 );        // zero length: signal to use initial frequencies
         infections.push_back(createInfection(Genotypes::sampleGenotype(weights)));
+        util::profile::count( util::profile::INFECTIONS_CREATED );
     }
     assert( numInfs == static_cast<int>(infections.size()) );
 }
@@ -144,23 +151,26 @@ void CommonWithinHost::importInfection(){
 void CommonWithinHost::update(int nNewInfs, vector<double>& genotype_weights,
         double ageInYears, double bsvFactor)
 {
+    util::profile::Scope profileScope( util::profile::WITHIN_HOST_UPDATE );
+    
     // Cache total density for infectiousness calculations
     int y_lag_i = sim::ts0().moduloSteps(y_lag_len);
     for( size_t g = 0; g < Genotypes::N(); ++g ) m_y_lag.at(y_lag_i, g) = 0.0;
-    for( std::list<CommonInfection*>::iterator inf = infections.begin(); inf != infections.end(); ++inf ){
-        m_y_lag.at( y_lag_i, (*inf)->genotype() ) += (*inf)->getDensity();
+    for( size_t i = 0; i < infections.size(); ++i ){
+        m_y_lag.at( y_lag_i, infections[i]->genotype() ) += infections[i]->getDensity();
     }
     
     // Note: adding infections at the beginning of the update instead of the end
     // shouldn't be significant since before latentp delay nothing is updated.
-    PopulationStats::totalInfections += nNewInfs;
+    const int nIntroduced = nNewInfs;
     nNewInfs=min(nNewInfs,MAX_INFECTIONS-numInfs);
-    PopulationStats::allowedInfections += nNewInfs;
+    PopulationStats::addInfections( nIntroduced, nNewInfs );
     numInfs += nNewInfs;
     assert( numInfs>=0 && numInfs<=MAX_INFECTIONS );
     for ( int i=0; i<nNewInfs; ++i ) {
         infections.push_back(createInfection (Genotypes::sampleGenotype(genotype_weights)));
     }
+    util::profile::count( util::profile::INFECTIONS_CREATED, nNewInfs );
     assert( numInfs == static_cast<int>(infections.size()) );
     
     updateImmuneStatus ();
@@ -168,6 +178,13 @@ void CommonWithinHost::update(int nNewInfs, vector<double>& genotype_weights,
     totalDensity = 0.0;
     timeStepMaxDensity = 0.0;
     
+    if( isIdle() ){
+        // Nothing to medicate, decay or update: the daily loop below would
+        // not change anything (nNewInfs is zero since there are no infections).
+        util::streamValidate(totalDensity);
+        return;
+    }
+    
     // As in AJTMH p22, cumulative_h (X_h + 1) doesn't include infections added
     // this time-step and cumulative_Y only includes past densities.
     double cumulative_h=m_cumulative_h;
@@ -186,24 +203,28 @@ void CommonWithinHost::update(int nNewInfs, vector<double>& genotype_weights,
         
         double sumLogDens = 0.0;
         
-        for (std::list<CommonInfection*>::iterator inf = infections.begin(); inf != infections.end();) {
+        size_t kept = 0;        // surviving infections are moved to the front, in order
+        for( size_t i = 0, n = infections.size(); i < n; ++i ){
+            CommonInfection* inf = infections[i];
             // Note: this is only one treatment model; there is also the PK/PD model
-            bool expires = ((*inf)->bloodStage() ? treatmentBlood : treatmentLiver);
+            bool expires = (inf->bloodStage() ? treatmentBlood : treatmentLiver);
             
             if( !expires ){     /* no expiry due to simple treatment model; do update */
                 double survivalFactor = survivalFactor_part *
-                    (*inf)->immunitySurvivalFactor(ageInYears, cumulative_h, cumulative_Y) *
-                    pkpdModel.getDrugFactor((*inf)->genotype());
+                    inf->immunitySurvivalFactor(ageInYears, cumulative_h, cumulative_Y) *
+                    pkpdModel.getDrugFactor(inf->genotype());
                 // update, may result in termination of infection:
-                expires = (*inf)->update(survivalFactor, now, body_mass);
+                expires = inf->update(survivalFactor, now, body_mass);
             }
             
             if( expires ){
-                delete *inf;
-                inf = infections.erase(inf);        // inf points to next infection now so don't increment with ++inf
+                delete inf;
                 --numInfs;
+                util::profile::count( util::profile::INFECTIONS_CLEARED );
             } else {
-                double density = (*inf)->getDensity();
+                infections[kept] = inf;
+                ++kept;
+                double density = inf->getDensity();
                 totalDensity += density;
                 timeStepMaxDensity = max(timeStepMaxDensity, density);
                 m_cumulative_Y += density;
@@ -211,9 +232,9 @@ void CommonWithinHost::update(int nNewInfs, vector<double>& genotype_weights,
                     // Base 10 logarithms are usually used; +1 because it avoids negatives in output while having very little affect on high densities
                     sumLogDens += log10(1.0 + density);
                 }
-                ++inf;
             }
         }
+        infections.resize( kept );
         pkpdModel.decayDrugs ();
     }
     
@@ -244,7 +265,7 @@ bool CommonWithinHost::summarize( const Host::Human& human )const{
     if( infections.size() > 0 ){
         mon::reportMHI( mon::MHR_INFECTED_HOSTS, human, 1 );
         if( reportInfectedOrPatentInfected ){
-            for (std::list<CommonInfection*>::const_iterator inf =
+            for (std::vector<CommonInfection*>::const_iterator inf =
                 infections.begin(); inf != infections.end(); ++inf) {
                 uint32_t genotype = (*inf)->genotype();
                 mon::reportMHGI( mon::MHR_INFECTIONS, human, genotype, 1 );
@@ -305,8 +326,8 @@ void CommonWithinHost::checkpoint (ostream& stream) {
     WHFalciparum::checkpoint (stream);
     hetMassMultiplier & stream;
     pkpdModel & stream;
-    for (std::list<CommonInfection*>::iterator inf = infections.begin(); inf != infections.end(); ++inf) {
-        (**inf) & stream;
+    for( size_t i = 0; i < infections.size(); ++i ){
+        (*infections[i]) & stream;
     }
 }
 }
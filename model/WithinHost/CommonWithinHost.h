@@ -68,6 +68,10 @@ public:
     
     virtual bool summarize( const Host::Human& human )const;
     
+    virtual bool isIdle() const{
+        return infections.empty() && pkpdModel.isIdle();
+    }
+    
 protected:
     virtual void clearInfections( Treatments::Stages stage );
     
@@ -81,12 +85,15 @@ private:
     /// Encapsulates drug code for each human
     PkPd::LSTMModel pkpdModel;
     
-    /** The list of all infections this human has.
+    /** The list of all infections this human has (oldest first).
      *
      * Since infection models and within host models are very much intertwined,
-     * the idea is that each WithinHostModel has its own list of infections. */
+     * the idea is that each WithinHostModel has its own list of infections.
+     * 
+     * Infections are removed by compacting the list in place, so its memory
+     * is reused rather than allocated per infection. */
     //TODO: better to template class over infection type than use dynamic type?
-    std::list<CommonInfection*> infections;
+    std::vector<CommonInfection*> infections;
 };
 
 } }
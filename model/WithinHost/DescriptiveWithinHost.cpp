@@ -82,9 +82,9 @@ void DescriptiveWithinHostModel::clearImmunity() {
     m_cumulative_Y_lag = 0.0;
 }
 void DescriptiveWithinHostModel::importInfection(){
-    PopulationStats::totalInfections += 1;
-    if( numInfs < MAX_INFECTIONS ){
-        PopulationStats::allowedInfections += 1;
+    const bool allowed = numInfs < MAX_INFECTIONS;
+    PopulationStats::addInfections( 1, allowed ? 1 : 0 );
+    if( allowed ){
         m_cumulative_h += 1;
         numInfs += 1;
         infections.push_back(DescriptiveInfection());
@@ -104,9 +104,9 @@ void DescriptiveWithinHostModel::update(int nNewInfs, vector<double>& genotype_w
     
     // Note: adding infections at the beginning of the update instead of the end
     // shouldn't be significant since before latentp delay nothing is updated.
-    PopulationStats::totalInfections += nNewInfs;
+    const int nIntroduced = nNewInfs;
     nNewInfs=min(nNewInfs,MAX_INFECTIONS-numInfs);
-    PopulationStats::allowedInfections += nNewInfs;
+    PopulationStats::addInfections( nIntroduced, nNewInfs );
     numInfs += nNewInfs;
     assert( numInfs>=0 && numInfs<=MAX_INFECTIONS );
     for ( int i=0; i<nNewInfs; ++i ) {
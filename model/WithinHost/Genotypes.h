@@ -23,6 +23,8 @@
 
 #include <iostream>
 
+class MosqTransmissionSuite;
+
 namespace OM { namespace WithinHost {
 
 /** Represents infection genotypes. */
@@ -82,6 +84,8 @@ public:
     
 private:
     static size_t N_genotypes;
+    
+    friend class ::MosqTransmissionSuite;
 };
 
 }
@@ -0,0 +1,93 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "WithinHost/Infection/CommonInfection.h"
+#include "util/parallel.h"
+
+#include <new>
+
+namespace OM { namespace WithinHost {
+
+// -----  memory pool  -----
+
+/* Free blocks of one size. Each free block stores a pointer to the next. */
+struct FreeList {
+    FreeList( size_t size ) : size(size), head(0) {}
+    size_t size;
+    void* head;
+};
+
+/* Free lists for each thread (indexed by util::parallel::threadIndex()) and
+ * block size. Only one infection type is used in a simulation, so there is
+ * usually one list per thread. A block freed by one thread may be reused by
+ * another; blocks are only memory of the right size. Memory is kept until
+ * exit. */
+vector<vector<FreeList> > infectionPools;
+
+/* Number of blocks allocated at once when a free list is empty. */
+const size_t POOL_CHUNK_BLOCKS = 64;
+
+inline FreeList& freeList( vector<FreeList>& lists, size_t size ){
+    for( size_t i = 0; i < lists.size(); ++i ){
+        if( lists[i].size == size ) return lists[i];
+    }
+    lists.push_back( FreeList( size ) );
+    return lists.back();
+}
+
+void CommonInfection::initPool(){
+    infectionPools.assign( util::parallel::numThreads(), vector<FreeList>() );
+}
+
+void* CommonInfection::operator new (size_t size){
+    const size_t t = util::parallel::threadIndex();
+    if( t >= infectionPools.size() ) return ::operator new (size);
+    
+    FreeList& list = freeList( infectionPools[t], size );
+    if( list.head == 0 ){
+        // Round up to keep blocks aligned as for any object; see ::operator new
+        const size_t align = 2 * sizeof(double);
+        const size_t blockSize = (max(size, sizeof(void*)) + align - 1) / align * align;
+        char* chunk = static_cast<char*>( ::operator new (blockSize * POOL_CHUNK_BLOCKS) );
+        for( size_t i = POOL_CHUNK_BLOCKS; i > 0; --i ){
+            void* block = chunk + (i - 1) * blockSize;
+            *static_cast<void**>(block) = list.head;
+            list.head = block;
+        }
+    }
+    void* block = list.head;
+    list.head = *static_cast<void**>(block);
+    return block;
+}
+
+void CommonInfection::operator delete (void* p, size_t size){
+    if( p == 0 ) return;
+    if( infectionPools.empty() ){
+        ::operator delete (p);
+        return;
+    }
+    // Heap blocks allocated before initPool() may also end up here; they
+    // are large enough for reuse.
+    FreeList& list = freeList( infectionPools[util::parallel::threadIndex()], size );
+    *static_cast<void**>(p) = list.head;
+    list.head = p;
+}
+
+} }
@@ -46,6 +46,19 @@ public:
     virtual ~CommonInfection() {}
     //@}
     
+    /** @brief Memory management
+     * 
+     * Infections are created and destroyed often, so they are allocated
+     * from per-thread pools of fixed-size blocks instead of the general
+     * heap. Until initPool() is called (e.g. in unit tests), the heap is
+     * used. */
+    //@{
+    /** Set up one pool per thread. Call after util::parallel::init(). */
+    static void initPool();
+    static void* operator new (size_t size);
+    static void operator delete (void* p, size_t size);
+    //@}
+    
     /** Get the infection's genotype. */
     uint32_t genotype()const{ return m_genotype; }
     
@@ -171,15 +171,17 @@ bool EmpiricalInfection::updateDensity( double survivalFactor, SimTime bsAge, do
   double amplificationPerCycle;
   double localDensity;	// density before scaling by _overallMultiplier
   size_t ageDays = bsAge.inDays();
+  // parameters of b_1, b_2, b_3 for today, sampled together below
+  const double mu_beta[3] = { _mu_beta1[ageDays], _mu_beta2[ageDays], _mu_beta3[ageDays] };
+  const double sigma_beta[3] = { _sigma_beta1[ageDays], _sigma_beta2[ageDays], _sigma_beta3[ageDays] };
   for (int tries0 = 0; tries0 < EI_MAX_SAMPLES; ++tries0) {
     double logDensity;
     for (int tries1 = 0; tries1 < EI_MAX_SAMPLES; ++tries1) {
-      double b_1=random::gauss(_mu_beta1[ageDays],_sigma_beta1[ageDays]);
-      double b_2=random::gauss(_mu_beta2[ageDays],_sigma_beta2[ageDays]);
-      double b_3=random::gauss(_mu_beta3[ageDays],_sigma_beta3[ageDays]);
-      double expectedlogDensity = b_1 * (L[0]+L[1]+L[2]) / 3
-      + b_2 * (L[2]-L[0]) / 2
-      + b_3 * (L[2]+L[0]-2*L[1]) / 4;
+      double b[3];
+      random::gauss( mu_beta, sigma_beta, b, 3 );
+      double expectedlogDensity = b[0] * (L[0]+L[1]+L[2]) / 3
+      + b[1] * (L[2]-L[0]) / 2
+      + b[2] * (L[2]+L[0]-2*L[1]) / 4;
       
       //include sampling error
       logDensity=random::gauss(expectedlogDensity,sigma_noise(ageDays));
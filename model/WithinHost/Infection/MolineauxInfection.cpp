@@ -58,11 +58,20 @@ static bool multi_factor_gamma = false;
 // pairwise sample of case-specific P* parameters
 static bool pairwise_P_star_sample = false;
 
+// use updateVariantsVector instead of updateVariantsScalar
+static bool vector_kernel = false;
+
 // q^(i+1) array
 // All the values of q^1... q^v are stored in this array.
 // This avoids the recalculation of those values every second time step. */
 static double qPow[MolineauxInfection::v];
 
+// Number of partial sums used by the vector kernel. Accumulating sums in
+// independent lanes lets the compiler vectorise these reductions (it may not
+// reorder floating-point additions itself).
+const size_t LANES = 4;
+const size_t v_lanes = MolineauxInfection::v - MolineauxInfection::v % LANES;
+
 // ———  hard-coded model constants  ———
 
 // sigma, rho: decay parameters, per day, of the acquired variant-specific and variant-transcending immune responses
@@ -198,23 +207,33 @@ void MolineauxInfection::init( const Parameters& parameters ){
    for( size_t i = 0; i < v; i++ ){
        qPow[i] = pow(q, static_cast<double>(i+1));
    }
+   
+   setVectorKernel( util::CommandLine::option( util::CommandLine::VECTOR_MOLINEAUX ) );
+}
+
+void MolineauxInfection::setVectorKernel( bool vectorKernel ){
+    vector_kernel = vectorKernel;
 }
 
 // ———  MolineauxInfection: initialisation  ———
 
 MolineauxInfection::MolineauxInfection(uint32_t genotype):
-        CommonInfection(genotype)
+        CommonInfection(genotype), nVariants(0)
 {
-    for( size_t i = 0; i < v; i++ ){
-        // Molineaux paper, equation 11
+    // Molineaux paper, equation 11. Samples less than 1 are rejected. We
+    // draw as many samples as there are variants left to fill each time,
+    // which consumes the same random numbers as sampling one at a time.
+    double samples[v];
+    for( size_t i = 0; i < v; ){
+        const size_t n = v - i;
         if( multi_factor_gamma ){
-            do{
-                mi[i] = static_cast<float>(random::gamma(shape_m,scale_m));
-            }while( mi[i]<1.0 );
+            random::gamma( shape_m, scale_m, samples, n );
         }else{
-            do{
-                mi[i] = static_cast<float>(random::gauss(mu_m, sigma_m));
-            }while( mi[i]<1.0 );
+            random::gauss( mu_m, sigma_m, samples, n );
+        }
+        for( size_t j = 0; j < n; ++j ){
+            mi[i] = static_cast<float>(samples[j]);
+            if( !(mi[i]<1.0) ) ++i;
         }
     }
     
@@ -223,6 +242,7 @@ MolineauxInfection::MolineauxInfection(uint32_t genotype):
     }
     
     Sm_summation = 0.0;
+    clearVariants();
     
     if( pairwise_P_star_sample ){
         int patient = util::random::uniform( 35 );
@@ -249,11 +269,16 @@ MolineauxInfection::MolineauxInfection(uint32_t genotype):
     }
 }
 
-MolineauxInfection::Variant::Variant () :
-        Pi1(0.0), Pi2(0.0), Si_summation(0.0)
-{
-    for (size_t tau=0; tau<taus; tau++){
-        lagged_Pi[tau] =  0.0;
+void MolineauxInfection::clearVariants(){
+    for( size_t i = 0; i < v; ++i ){
+        Pi1[i] = 0.0;
+        Pi2[i] = 0.0;
+        Si_summation[i] = 0.0;
+    }
+    for( size_t tau = 0; tau < taus; ++tau ){
+        for( size_t i = 0; i < v; ++i ){
+            lagged_Pi[tau][i] = 0.0;
+        }
     }
 }
 
@@ -273,15 +298,32 @@ bool MolineauxInfection::updateDensity( double survival_factor, SimTime age_BS,
     if (age_BS == sim::zero()){
         // The first variant starts with a pre-set density (regardless of blood
         // volume; this is an assumption by DH; paper assumes fixed volume)
-        variants.resize(1);
+        nVariants = 1;
         Pi[0] = initial_dens;
         m_density = initial_dens;
+    }else if( vector_kernel ){
+        double lane[LANES] = { 0.0 };
+        for( size_t i = 0; i < v_lanes; i += LANES ){
+            for( size_t j = 0; j < LANES; ++j ){
+                double newP = survival_factor * Pi1[i+j];
+                Pi[i+j] = newP;
+                Pi1[i+j] = static_cast<float>(survival_factor * Pi2[i+j]);
+                lane[j] += newP;
+            }
+        }
+        for( size_t i = v_lanes; i < v; ++i ){
+            double newP = survival_factor * Pi1[i];
+            Pi[i] = newP;
+            Pi1[i] = static_cast<float>(survival_factor * Pi2[i]);
+            lane[i - v_lanes] += newP;
+        }
+        m_density = (lane[0] + lane[1]) + (lane[2] + lane[3]);
     }else{
         double sum = 0.0;
-        for( size_t i = 0; i < variants.size(); i++ ){
-            double newP = survival_factor * variants[i].Pi1;
+        for( size_t i = 0; i < nVariants; i++ ){
+            double newP = survival_factor * Pi1[i];
             Pi[i] = newP;
-            variants[i].Pi1 = static_cast<float>(survival_factor * variants[i].Pi2);
+            Pi1[i] = static_cast<float>(survival_factor * Pi2[i]);
             sum += newP;
         }
         m_density = sum;
@@ -328,22 +370,35 @@ bool MolineauxInfection::updateDensity( double survival_factor, SimTime age_BS,
     //double Sm = (1.0 - beta) / (1.0 + pow(Sm_summation / Pm_star, kappa_m)) + beta
     const double Sm = (1.0 - beta) / (1.0 + Sm_summation / Pm_star) + beta;
     
+    // ———  4, 5. variant-specific immune responses and densities  ———
+    if( vector_kernel ){
+        updateVariantsVector( Pi, tau, Sc, Sm, elim_dens );
+    }else{
+        updateVariantsScalar( Pi, tau, Sc, Sm, elim_dens );
+    }
+    
+    return false;       // end of update, not extinct
+}
+
+void MolineauxInfection::updateVariantsScalar( const double* Pi, size_t tau,
+        double Sc, double Sm, double elim_dens )
+{
     // ———  4. variant-specific immune response (equation 6)  ———
     double Si[v];       // calculate value for each variant
     double sum_qj_Sj=0.0;       // simultaneously calculation summataion in equation 4
     
     for (size_t i = 0; i < v; i++){
-        if( i < variants.size() ){
+        if( i < nVariants ){
             // 4.a) Update the sum in (6) based on the last step's value
             //note: sigma_decay = exp(-2*sigma)
-            variants[i].Si_summation = static_cast<float>(
-                variants[i].Si_summation * sigma_decay + variants[i].lagged_Pi[tau]);
+            Si_summation[i] = static_cast<float>(
+                Si_summation[i] * sigma_decay + lagged_Pi[tau][i]);
             // 4.b) update history of density (P_i(t))
-            variants[i].lagged_Pi[tau] = static_cast<float>(Pi[i]);
+            lagged_Pi[tau][i] = static_cast<float>(Pi[i]);
             
             // 4.c) calculate S_i(t) (equation 6)
             BOOST_STATIC_ASSERT( kappa_v == 3 );        // again, optimise pow to multiplication
-            const double base = variants[i].Si_summation * inv_Pv_star;
+            const double base = Si_summation[i] * inv_Pv_star;
             Si[i] = 1.0 / (1.0 + base*base*base);        // eqn 6, given κ_v = 3
         }else{
             Si[i] = 1.0; // eqn 6 for the case when P_i(τ) = 0 for τ ≤ t - δ_m
@@ -363,30 +418,76 @@ bool MolineauxInfection::updateDensity( double survival_factor, SimTime age_BS,
         // 4.b) calculate P_i'(t+2) [eqn 1] then P_i(t+2) [eqn 2]
         // This is the growth rate after taking immune effect into account:
         double growth_factor = mi[i] * Si[i] * Sc * Sm;   // part of eqn 1
-        if( i < variants.size() ){
+        if( i < nVariants ){
             // Pi_prime: the variant's density at time t+2 (eqn 1)
             double Pi_prime = ( (1.0 - s) * Pi[i] + s * p_i * m_density ) * growth_factor;
             
             if( Pi_prime < elim_dens ) Pi_prime = 0.0;    // eqn 2
             
-            variants[i].Pi1 = static_cast<float>(sqrt(Pi[i] * Pi_prime));
-            variants[i].Pi2 = static_cast<float>(Pi_prime);
+            Pi1[i] = static_cast<float>(sqrt(Pi[i] * Pi_prime));
+            Pi2[i] = static_cast<float>(Pi_prime);
         }else{
-            // In this case P_i(τ) = 0 for all τ ≤ t, and we haven't allocated storage.
+            // In this case P_i(τ) = 0 for all τ ≤ t, and state is zero.
             
             // Pi_prime: the variant's density at time t+2 (eqn 1 in paper)
             double Pi_prime = ( s * p_i * m_density ) * growth_factor;
             
             // Molineaux paper equation 2
             if( Pi_prime >= elim_dens ){    // [if not, P_i(t+2) = 0]
-                // express a new variant at time t+2:
-                variants.resize( i+1 ); // allocate (potentially for multiple variants)
-                variants[i].Pi2 = static_cast<float>(Pi_prime);
+                // express a new variant at time t+2 (and all before it):
+                nVariants = i+1;
+                Pi2[i] = static_cast<float>(Pi_prime);
             }
         }
     }
+}
+
+void MolineauxInfection::updateVariantsVector( const double* Pi, size_t tau,
+        double Sc, double Sm, double elim_dens )
+{
+    // Same equations as updateVariantsScalar, but over all variants: those
+    // not yet expressed have zero state, giving Si = 1 and Pi_prime as
+    // calculated for them there.
     
-    return false;       // end of update, not extinct
+    // ———  4. variant-specific immune response (equation 6)  ———
+    double Si[v];
+    float* lagged = lagged_Pi[tau];
+    for( size_t i = 0; i < v; ++i ){
+        Si_summation[i] = static_cast<float>(
+            Si_summation[i] * sigma_decay + lagged[i]);
+        lagged[i] = static_cast<float>(Pi[i]);
+        const double base = Si_summation[i] * inv_Pv_star;
+        Si[i] = 1.0 / (1.0 + base*base*base);        // eqn 6, given κ_v = 3
+    }
+    
+    double lane[LANES] = { 0.0 };       // sum in eqn 4
+    for( size_t i = 0; i < v_lanes; i += LANES ){
+        for( size_t j = 0; j < LANES; ++j ){
+            lane[j] += qPow[i+j] * Si[i+j];
+        }
+    }
+    for( size_t i = v_lanes; i < v; ++i ){
+        lane[i - v_lanes] += qPow[i] * Si[i];
+    }
+    const double sum_qj_Sj = (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    
+    // ———  5. Variant densities, equations 1, 2 and 4  ———
+    for( size_t i = 0; i < v; ++i ){
+        const double p_i = Si[i] >= 0.1 ? qPow[i] * Si[i] / sum_qj_Sj : 0.0;
+        const double growth_factor = mi[i] * Si[i] * Sc * Sm;
+        double Pi_prime = ( (1.0 - s) * Pi[i] + s * p_i * m_density ) * growth_factor;
+        Pi_prime = Pi_prime < elim_dens ? 0.0 : Pi_prime;    // eqn 2
+        Pi1[i] = static_cast<float>(sqrt(Pi[i] * Pi_prime));
+        Pi2[i] = static_cast<float>(Pi_prime);
+    }
+    
+    // newly expressed variants
+    for( size_t i = v; i > nVariants; --i ){
+        if( Pi2[i-1] != 0.0f ){
+            nVariants = i;
+            break;
+        }
+    }
 }
 
 // ———  MolineauxInfection: checkpointing  ———
@@ -398,7 +499,23 @@ MolineauxInfection::MolineauxInfection (istream& stream) :
     for (size_t i=0;i<v;i++) {
         mi[i] & stream;
     }
-    variants & stream;
+    clearVariants();
+    nVariants & stream;
+    if( nVariants > v )
+        throw util::checkpoint_error( "MolineauxInfection: too many variants" );
+    for( size_t i = 0; i < nVariants; ++i ){
+        // Only variants with non-zero state were written
+        bool nonZero;
+        nonZero & stream;
+        if( nonZero ){
+            Pi1[i] & stream;
+            Pi2[i] & stream;
+            Si_summation[i] & stream;
+            for( size_t tau = 0; tau < taus; ++tau ){
+                lagged_Pi[tau][i] & stream;
+            }
+        }
+    }
     for (size_t j=0;j<taus;j++){
         lagged_Pc[j] & stream;
     }
@@ -413,7 +530,22 @@ void MolineauxInfection::checkpoint (ostream& stream) {
     for (size_t i=0;i<v;i++) {
         mi[i] & stream;
     }
-    variants & stream;
+    nVariants & stream;
+    for( size_t i = 0; i < nVariants; ++i ){
+        bool nonZero =
+                Pi1[i] != 0.0 ||
+                Pi2[i] != 0.0 ||
+                Si_summation[i] != 0.0;
+        nonZero & stream;
+        if( nonZero ){
+            Pi1[i] & stream;
+            Pi2[i] & stream;
+            Si_summation[i] & stream;
+            for( size_t tau = 0; tau < taus; ++tau ){
+                lagged_Pi[tau][i] & stream;
+            }
+        }
+    }
     for (size_t j=0;j<taus;j++){
         lagged_Pc[j] & stream;
     }
@@ -421,36 +553,5 @@ void MolineauxInfection::checkpoint (ostream& stream) {
     Pm_star & stream;
 }
 
-void MolineauxInfection::Variant::operator& (istream& stream) {
-    bool nonZero;
-    nonZero & stream;
-    if( nonZero ){
-        Pi1 & stream;
-        Pi2 & stream;
-        Si_summation & stream;
-        for(size_t i = 0; i < taus; ++i){
-            lagged_Pi[i] & stream;
-        }
-    }
-    // else: all members are zero-initialised by the constructor, so don't do anything
-}
-
-void MolineauxInfection::Variant::operator& (ostream& stream) {
-    bool nonZero =
-            Pi1 != 0.0 ||
-            Pi2 != 0.0 ||
-            Si_summation != 0.0;
-
-    nonZero & stream;
-    if( nonZero ){
-        Pi1 & stream;
-        Pi2 & stream;
-        Si_summation & stream;
-        for(size_t i = 0; i < taus; ++i){
-            lagged_Pi[i] & stream;
-        }
-    }
-}
-
 }
 }
@@ -48,6 +48,17 @@ public:
     static const size_t v = 50;
     // taus: used for the variantTranscending and variantSpecific array, 4 Molineaux time steps = 8 days
     static const size_t taus = 4;
+    
+    /** Select the implementation of the variant updates (equations 1, 2,
+     * 4 and 6). The default is the scalar kernel, which only visits
+     * expressed variants. The vector kernel updates all v variants with
+     * branch-free loops which compilers can vectorise; unexpressed variants
+     * have zero state, so this gives the same values except that sums are
+     * accumulated in several lanes. Densities after one update therefore
+     * agree with those of the scalar kernel to a relative tolerance of 1e-6
+     * (the precision of the stored floats), but since equations 2 and 4
+     * apply thresholds, trajectories of single infections may diverge. */
+    static void setVectorKernel( bool vectorKernel );
     //@}
     
     // Initialise. Samples several parameters.
@@ -62,7 +73,12 @@ protected:
     virtual void checkpoint (ostream& stream);
     
 private:
-    double getVariantSpecificSummation(int i, double P_current);
+    /// Set all variant state to zero
+    void clearVariants();
+    
+    /// Variant updates (steps 4 and 5 of updateDensity); see setVectorKernel()
+    void updateVariantsScalar( const double* Pi, size_t tau, double Sc, double Sm, double elim_dens );
+    void updateVariantsVector( const double* Pi, size_t tau, double Sc, double Sm, double elim_dens );
     
     // Note: we also have inherited parameters:
     // m_startDate is used to give the age here
@@ -78,21 +94,14 @@ private:
      * between the last positive day and the first positive day. */
     float Pc_star, Pm_star;
     
-    struct Variant {
-        // Initialise all variables to 0
-        Variant ();
-        
-        /// Checkpointing
-        void operator& (ostream& stream);
-        void operator& (istream& stream);
-        
-        float Pi1, Pi2;   // Pi(t+1), Pi(t+2): variant's i density (PRBC/μl blood)
-        float Si_summation;     // sum in eqn 6
-        // index: we use ((bsAge.inDays()/2) mod 4) for τ = t - δ_v respectively τ = t
-        float lagged_Pi[taus];   // Pi(τ) for τ ∈ {t - δ_v, ..., t - 2}
-    };
-    // variant-specific data; variants[i-1] corresponds to variant i in the paper
-    vector<Variant> variants;
+    /* Variant-specific data, stored as a structure of arrays with fixed
+     * capacity v; index i corresponds to variant i+1 in the paper. Only the
+     * first nVariants (expressed variants) may have non-zero state. */
+    size_t nVariants;
+    float Pi1[v], Pi2[v];       // Pi(t+1), Pi(t+2): variant's i density (PRBC/μl blood)
+    float Si_summation[v];      // sum in eqn 6
+    // first index: we use ((bsAge.inDays()/2) mod 4) for τ = t - δ_v respectively τ = t
+    float lagged_Pi[taus][v];   // Pi(τ) for τ ∈ {t - δ_v, ..., t - 2}
     
     // allow unittest to access private vars
     friend class ::MolineauxInfectionSuite;
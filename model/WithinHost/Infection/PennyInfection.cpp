@@ -170,17 +170,23 @@ PennyInfection::PennyInfection(uint32_t protID):
         clonalSummation(0)
 {
     // assign infection dependent immune thresholds
+    // thresholds N, C, V are sampled together
+    double x[3];
     if( immune_threshold_gamma )/* using gamma distribution */{
+        const double a[3] = { a_TN, a_TC, a_TV }, b[3] = { b_TN, b_TC, b_TV };
         do {
-            threshold_N = exp(random::gamma(a_TN,b_TN));
-            threshold_C = exp(random::gamma(a_TC,b_TC));
-            threshold_V = exp(random::gamma(a_TV,b_TV));
+            random::gamma( a, b, x, 3 );
+            threshold_N = exp(x[0]);
+            threshold_C = exp(x[1]);
+            threshold_V = exp(x[2]);
         } while(threshold_N <= threshold_C || threshold_N <= threshold_V);
     }else /* using lognormal distribution */{
+        const double mu[3] = { mu_TN, mu_TC, mu_TV }, sigma[3] = { sigma_TN, sigma_TC, sigma_TV };
         do {
-            threshold_N = exp(random::gauss(mu_TN,sigma_TN));
-            threshold_C = exp(random::gauss(mu_TC,sigma_TC));
-            threshold_V = exp(random::gauss(mu_TV,sigma_TV));
+            random::gauss( mu, sigma, x, 3 );
+            threshold_N = exp(x[0]);
+            threshold_C = exp(x[1]);
+            threshold_V = exp(x[2]);
         } while(threshold_N <= threshold_C || threshold_N <= threshold_V);
     }
     
@@ -197,22 +203,20 @@ bool PennyInfection::updateDensity( double survivalFactor, SimTime bsAge, double
     int ageDays = bsAge.inDays();       // lazy
     if( bsAge == sim::zero() ){
         // assign initial densities (Y circulating, X sequestered)
-        size_t today = mod_nn(ageDays, delta_C);
-        
+        double x[2];
         if(update_density_gamma) {
-            cirDensities[today] = exp(random::gamma(a_Y,b_Y));
+            const double a[2] = { a_Y, a_X }, b[2] = { b_Y, b_X };
+            random::gamma( a, b, x, 2 );
         } else {
-            cirDensities[today] = exp(random::gauss(mu_Y,sigma_Y));
+            const double mu[2] = { mu_Y, mu_X }, sigma[2] = { sigma_Y, sigma_X };
+            random::gauss( mu, sigma, x, 2 );
         }
         
+        size_t today = mod_nn(ageDays, delta_C);
+        cirDensities[today] = exp(x[0]);
         m_density = cirDensities[today];
         today = mod_nn(ageDays, delta_V);
-        
-        if(update_density_gamma){
-            seqDensities[today] = exp(random::gamma(a_X,b_X));
-        } else {
-            seqDensities[today] = exp(random::gauss(mu_X,sigma_X));
-        }
+        seqDensities[today] = exp(x[1]);
     }
     else /*not first day*/
     {
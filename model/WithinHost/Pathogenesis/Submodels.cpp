@@ -81,7 +81,8 @@ void PyrogenPathogenesis::init( const Parameters& parameters ){
 }
 
 PyrogenPathogenesis::PyrogenPathogenesis(double cF) :
-     PathogenesisModel (cF), _pyrogenThres (initPyroThres)
+     PathogenesisModel (cF), _pyrogenThres (initPyroThres),
+     m_thresTime (sim::nowOrTs1())
 {}
 
 
@@ -91,14 +92,24 @@ double PyrogenPathogenesis::getPEpisode(double timeStepMaxDensity, double totalD
 }
 
 void PyrogenPathogenesis::summarize (const Host::Human& human) {
+    decayTo( sim::now() );
     mon::reportMHF( mon::MHF_PYROGENIC_THRESHOLD, human, _pyrogenThres );
     mon::reportMHF( mon::MHF_LOG_PYROGENIC_THRESHOLD, human, log(_pyrogenThres+1.0) );
 }
 
 void PyrogenPathogenesis::updatePyrogenThres(double totalDensity){
     // Note: this calculation is slow (something like 5% of runtime)
+    decayTo( sim::ts0() );
+    m_thresTime = sim::ts1();
     
     //Numerical approximation to equation 2, AJTMH p.57
+    if( totalDensity == 0.0 ){
+        // Common case (uninfected hosts): the first term is zero, leaving only decay
+        for( size_t i = 1; i <= n; ++i ){
+            _pyrogenThres += b * _pyrogenThres;
+        }
+        return;
+    }
     for( size_t i = 1; i <= n; ++i ){
         _pyrogenThres += totalDensity * a /
             ( (Ystar1_26 + totalDensity) * (Ystar2_13 + _pyrogenThres) )
@@ -106,14 +117,26 @@ void PyrogenPathogenesis::updatePyrogenThres(double totalDensity){
     }
 }
 
+void PyrogenPathogenesis::decayTo( SimTime time ){
+    // Steps skipped for idle hosts had zero density, leaving only the decay
+    // of updatePyrogenThres(), applied here in one go
+    if( m_thresTime < time ){
+        const int steps = (time - m_thresTime) / sim::oneTS();
+        _pyrogenThres *= pow( 1.0 + b, static_cast<double>(n * steps) );
+        m_thresTime = time;
+    }
+}
+
 
 void PyrogenPathogenesis::checkpoint (istream& stream) {
     PathogenesisModel::checkpoint (stream);
     _pyrogenThres & stream;
+    m_thresTime & stream;
 }
 void PyrogenPathogenesis::checkpoint (ostream& stream) {
     PathogenesisModel::checkpoint (stream);
     _pyrogenThres & stream;
+    m_thresTime & stream;
 }
 
 
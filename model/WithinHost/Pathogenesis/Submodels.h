@@ -46,8 +46,13 @@ class PyrogenPathogenesis : public PathogenesisModel {
 protected:
     /// Critical density for fever (clinical episodes)
     double _pyrogenThres;
+    /// Time up to which _pyrogenThres has been updated
+    SimTime m_thresTime;
     /// Determine the current pyrogenic threshold.
     virtual void updatePyrogenThres(double totalDensity);
+    /** Apply the decay of steps not updated (see Host::Human::update()), up
+     * to the given time. */
+    void decayTo( SimTime time );
 
 public:
     PyrogenPathogenesis(double cF);
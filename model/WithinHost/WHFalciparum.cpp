@@ -83,7 +83,8 @@ WHFalciparum::WHFalciparum( double comorbidityFactor ):
     WHInterface(),
     m_cumulative_h(0.0), m_cumulative_Y(0.0), m_cumulative_Y_lag(0.0),
     totalDensity(0.0), timeStepMaxDensity(0.0),
-    pathogenesisModel( Pathogenesis::PathogenesisModel::createPathogenesisModel( comorbidityFactor ) )
+    pathogenesisModel( Pathogenesis::PathogenesisModel::createPathogenesisModel( comorbidityFactor ) ),
+    m_infectiousnessTime(sim::never()), m_x(0.0), m_pTransmit(0.0)
 {
     // NOTE: negating a Gaussian sample with mean 0 is pointless — except that
     // the individual samples change. In any case the overhead is negligible.
@@ -107,6 +108,19 @@ const double PTM_tau_prime = 1.0 / sqrt(1.0 / PTM_tau);
 const double PTM_mu= -8.1;
 
 double WHFalciparum::probTransmissionToMosquito( double tbvFactor, double *sumX ) const{
+    updateInfectiousness();
+    if( sumX != 0 ) *sumX = 1.0 / m_x;    // copy to sumX, if set
+    if( m_x < 0.001 ) return 0.0; // cut off for uninfectious humans
+    
+    // Include here the effect of transmission-blocking vaccination:
+    double pTransmit = m_pTransmit * tbvFactor;
+    util::streamValidate( pTransmit );
+    return pTransmit;
+}
+void WHFalciparum::updateInfectiousness() const{
+    if( m_infectiousnessTime == sim::ts0() ) return;
+    m_infectiousnessTime = sim::ts0();
+    
     // This model (often referred to as the gametocyte model) was designed for
     // 5-day time steps. We use the same model (sampling 10, 15 and 20 days
     // ago) for 1-day time steps to avoid having to design and analyse a new
@@ -127,22 +141,19 @@ double WHFalciparum::probTransmissionToMosquito( double tbvFactor, double *sumX
         y20 += m_y_lag.at(mod_nn(i10 - i10d, y_lag_len), genotype);
     }
     // Weighted sum:
-    const double x = PTM_beta1 * y10 + PTM_beta2 * y15 + PTM_beta3 * y20;
-    if( sumX != 0 ) *sumX = 1.0 / x;    // copy to sumX, if set
-    if( x < 0.001 ) return 0.0; // cut off for uninfectious humans
+    m_x = PTM_beta1 * y10 + PTM_beta2 * y15 + PTM_beta3 * y20;
+    if( m_x < 0.001 ){
+        m_pTransmit = 0.0;
+        return;
+    }
     
     // Get a zval, convert to equivalent Normal sample:
-    const double zval = (log(x) + PTM_mu) * PTM_tau_prime;
+    const double zval = (log(m_x) + PTM_mu) * PTM_tau_prime;
     const double pone = gsl_cdf_ugaussian_P(zval);
     double pTransmit = pone*pone;
     // pTransmit has to be between 0 and 1:
     pTransmit=std::max(pTransmit, 0.0);
-    pTransmit=std::min(pTransmit, 1.0);
-    
-    // Include here the effect of transmission-blocking vaccination:
-    pTransmit *= tbvFactor;
-    util::streamValidate( pTransmit );
-    return pTransmit;
+    m_pTransmit=std::min(pTransmit, 1.0);
 }
 double WHFalciparum::pTransGenotype(double pTrans, double sumX, size_t genotype)
 {
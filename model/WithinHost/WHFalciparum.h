@@ -130,6 +130,27 @@ protected:
     virtual void checkpoint (istream& stream);
     virtual void checkpoint (ostream& stream);
 
+private:
+    /// Calculate m_x and m_pTransmit for sim::ts0(), unless already done.
+    void updateInfectiousness() const;
+    
+    /** @brief Infectiousness cache
+     * 
+     * probTransmissionToMosquito() is called several times per time step (by
+     * the vector and kappa updates). Its value depends only on entries of
+     * m_y_lag from previous steps: the update writes only the entry for
+     * sim::ts0(), which is not read for this step. Hence intermediate values
+     * are calculated once per step. Not checkpointed. */
+    //@{
+    /// Time step for which the values below are valid
+    mutable SimTime m_infectiousnessTime;
+    /// Weighted sum of lagged densities
+    mutable double m_x;
+    /// Probability of infecting a mosquito, excluding the TBV factor
+    mutable double m_pTransmit;
+    //@}
+    
+protected:
     ///@brief Static parameters, set by init()
     //@{
 //Standard dev innate immunity for densities
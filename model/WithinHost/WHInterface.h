@@ -107,8 +107,8 @@ public:
      *  expected to be zero when not using WHFalciparum.
      * @returns the probability of this human infecting a feeding mosquito.
      * 
-     * Calculates the value during the call, which is expensive (cache externally
-     * if the value is needed multiple times). */
+     * WHFalciparum caches the expensive part of this calculation per time
+     * step; also see TransmissionModel::updateInfectiousness(). */
     virtual double probTransmissionToMosquito( double tbvFactor,
                                                double *sumX )const =0;
     /** Calculates a probability of transmitting an infection of a given
@@ -122,6 +122,12 @@ public:
     
     /// @returns true if host has patent parasites
     virtual bool summarize(const Host::Human& human) const =0;
+    
+    /** Returns true when the host has no infections and no drugs (in the body
+     * or pending). An update() without new infections then only decays
+     * immunity and records zero densities, which some models do via a fast
+     * path. Default: false (no fast path). */
+    virtual bool isIdle() const{ return false; }
 
     /// Create a new infection within this human
     virtual void importInfection() =0;
@@ -28,6 +28,7 @@
 #include "Population.h"
 #include "Transmission/TransmissionModel.h"
 #include "util/random.h"
+#include "interventions/SubPopIndex.h"
 #include <schema/interventions.h>
 
 namespace OM { namespace interventions {
@@ -242,14 +243,11 @@ public:
     }
     
     virtual void deploy (OM::Population& population) {
-        for (Population::Iter iter = population.begin(); iter != population.end(); ++iter) {
-            SimTime age = iter->age(sim::now());
-            if( age >= minAge && age < maxAge ){
-                if( subPop == interventions::ComponentId_pop || (iter->isInSubPop( subPop ) != complement) ){
-                    if( util::random::bernoulli( coverage ) ){
-                        deployToHuman( *iter, mon::Deploy::TIMED );
-                    }
-                }
+        vector<Host::Human*> eligible;
+        selectEligible( population, eligible );
+        for( vector<Host::Human*>::iterator iter = eligible.begin(); iter != eligible.end(); ++iter ){
+            if( util::random::bernoulli( coverage ) ){
+                deployToHuman( **iter, mon::Deploy::TIMED );
             }
         }
     }
@@ -266,6 +264,31 @@ public:
 #endif
     
 protected:
+    /** Set eligible to the humans within the age range and (if restricted)
+     * sub-population, in population order. */
+    void selectEligible( OM::Population& population, vector<Host::Human*>& eligible ) const{
+        eligible.clear();
+        size_t first, last;     // humans within the age range
+        population.ageRange( sim::now(), minAge, maxAge, first, last );
+        if( subPop == interventions::ComponentId_pop || complement ){
+            for( size_t i = first; i < last; ++i ){
+                Host::Human& human = population.human( i );
+                if( subPop == interventions::ComponentId_pop || (human.isInSubPop( subPop ) != complement) ){
+                    eligible.push_back( &human );
+                }
+            }
+        }else{
+            // only members can be eligible: visit just these (in the same
+            // order, so random draws are unchanged)
+            vector<size_t> members;
+            SubPopIndex::members( subPop, population, members );
+            for( vector<size_t>::const_iterator it = members.begin(); it != members.end(); ++it ){
+                if( *it >= first && *it < last )
+                    eligible.push_back( &population.human( *it ) );
+            }
+        }
+    }
+    
     // restrictions on deployment
     SimTime minAge, maxAge;
 };
@@ -294,17 +317,16 @@ public:
     virtual void deploy (OM::Population& population) {
         // Cumulative case: bring target group's coverage up to target coverage
         vector<Host::Human*> unprotected;
-        size_t total = 0;       // number of humans within age bound and optionally subPop
-        for (Population::Iter iter = population.begin(); iter != population.end(); ++iter) {
-            SimTime age = iter->age(sim::now());
-            if( age >= minAge && age < maxAge ){
-                if( subPop == interventions::ComponentId_pop || (iter->isInSubPop( subPop ) != complement) ){
-                    total+=1;
-                    if( !iter->isInSubPop(cumCovInd) )
-                        unprotected.push_back( &*iter );
-                }
+        selectEligible( population, unprotected );
+        size_t total = unprotected.size();       // number of humans within age bound and optionally subPop
+        size_t w = 0;
+        for( size_t r = 0; r < total; ++r ){
+            if( !unprotected[r]->isInSubPop(cumCovInd) ){
+                unprotected[w] = unprotected[r];
+                ++w;
             }
         }
+        unprotected.resize( w );
         
         if( total == 0 ) return;        // no humans to deploy to; avoid divide by zero
         double propProtected = static_cast<double>( total - unprotected.size() ) / static_cast<double>( total );
@@ -378,6 +400,9 @@ public:
         }
     }
     
+    /// Age at which humans are targeted
+    inline SimTime getDeployAge()const{ return deployAge; }
+    
     /// For sorting
     inline bool operator<( const ContinuousHumanDeployment& that )const{
         return this->deployAge < that.deployAge;
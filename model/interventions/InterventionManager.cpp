@@ -22,12 +22,14 @@
 #include "Population.h"
 #include "util/random.h"
 #include "util/CommandLine.h"
+#include "util/profile.h"
 #include "interventions/GVI.h"
 #include "interventions/IRS.h"
 #include "interventions/ITN.h"
 #include "interventions/Vaccine.h"
 #include "interventions/HumanInterventionComponents.hpp"
 #include "interventions/Deployments.hpp"
+#include "interventions/SubPopIndex.h"
 #include "WithinHost/Diagnostic.h"
 
 namespace OM { namespace interventions {
@@ -42,6 +44,7 @@ boost::ptr_vector<HumanIntervention> InterventionManager::humanInterventions;
 ptr_vector<ContinuousHumanDeployment> InterventionManager::continuous;
 ptr_vector<TimedDeployment> InterventionManager::timed;
 uint32_t InterventionManager::nextTimed;
+vector<SimTime> InterventionManager::ctsDeployAges;
 OM::Host::ImportedInfections InterventionManager::importedInfections;
 
 // static functions:
@@ -211,6 +214,8 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, OM::Popu
                     const string& subPopStr = timedIt->getRestrictToSubPop().get().getId();
                     subPop = getComponentId( subPopStr );
                     complement = timedIt->getRestrictToSubPop().get().getComplement();
+                    if( !complement )
+                        SubPopIndex::track( subPop );   // see TimedHumanDeployment::selectEligible
                 }
                 try{
                     if( timedIt->getCumulativeCoverage().present() ){
@@ -300,6 +305,12 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, OM::Popu
     // the same without as with a hacked BOOST version including stable_sort.
     continuous.sort();
     timed.sort();
+    ctsDeployAges.clear();
+    for( ptr_vector<ContinuousHumanDeployment>::const_iterator it =
+        continuous.begin(); it != continuous.end(); ++it ){
+        if( ctsDeployAges.empty() || ctsDeployAges.back() != it->getDeployAge() )
+            ctsDeployAges.push_back( it->getDeployAge() );
+    }
     
     // make sure the list ends with something always in the future, so we don't
     // have to check nextTimed is within range:
@@ -364,6 +375,7 @@ void InterventionManager::loadFromCheckpoint( OM::Population& population, SimTim
 void InterventionManager::deploy(OM::Population& population) {
     if( sim::intervNow() < sim::zero() )
         return;
+    util::profile::Scope profileScope( util::profile::INTERVENTIONS );
     
     // deploy imported infections (not strictly speaking an intervention)
     importedInfections.import( population );
@@ -375,14 +387,23 @@ void InterventionManager::deploy(OM::Population& population) {
     }
     
     // deploy continuous interventions
-    for( Population::Iter it = population.begin(); it != population.end(); ++it ){
-        uint32_t nextCtsDist = it->getNextCtsDist();
-        // deploy continuous interventions
-        while( nextCtsDist < continuous.size() )
-        {
-            if( !continuous[nextCtsDist].filterAndDeploy( *it, population ) )
-                break;  // deployment (and all remaining) happens in the future
-            nextCtsDist = it->incrNextCtsDist();
+    // Humans only receive these when exactly at a target age, thus we only
+    // visit humans of these ages; taking ages in decreasing order visits
+    // humans in population order, as a full walk would.
+    for( vector<SimTime>::const_reverse_iterator age = ctsDeployAges.rbegin();
+        age != ctsDeployAges.rend(); ++age )
+    {
+        size_t first, last;
+        population.ageRange( sim::now(), *age, *age + sim::oneTS(), first, last );
+        for( size_t i = first; i < last; ++i ){
+            Host::Human& human = population.human( i );
+            uint32_t nextCtsDist = human.getNextCtsDist();
+            while( nextCtsDist < continuous.size() )
+            {
+                if( !continuous[nextCtsDist].filterAndDeploy( human, population ) )
+                    break;  // deployment (and all remaining) happens in the future
+                nextCtsDist = human.incrNextCtsDist();
+            }
         }
     }
 }
@@ -92,6 +92,8 @@ private:
     static boost::ptr_vector<HumanIntervention> humanInterventions;
     // Continuous interventions, sorted by deployment age (weakly increasing)
     static ptr_vector<ContinuousHumanDeployment> continuous;
+    // Distinct deployment ages of continuous interventions (increasing)
+    static vector<SimTime> ctsDeployAges;
     // List of all timed interventions. Should be sorted (time weakly increasing).
     static ptr_vector<TimedDeployment> timed;
     static uint32_t nextTimed;  // not chcekpointed (see loadFromCheckpoint)
@@ -0,0 +1,101 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "interventions/SubPopIndex.h"
+#include "Population.h"
+
+#include <algorithm>
+
+namespace OM { namespace interventions {
+
+vector<bool> SubPopIndex::tracked;
+vector<vector<uint32_t> > SubPopIndex::memberIds;
+vector<vector<pair<size_t,uint32_t> > > SubPopIndex::pending;
+
+void SubPopIndex::track( ComponentId id ){
+    assert( id.id != ComponentId_pop.id );
+    if( id.id >= tracked.size() ){
+        tracked.resize( id.id + 1, false );
+        memberIds.resize( id.id + 1 );
+    }
+    tracked[id.id] = true;
+    pending.resize( util::parallel::numThreads() );
+}
+
+void SubPopIndex::merge(){
+    vector<size_t> oldSize( memberIds.size() );
+    for( size_t c = 0; c < memberIds.size(); ++c )
+        oldSize[c] = memberIds[c].size();
+    for( size_t t = 0; t < pending.size(); ++t ){
+        for( vector<pair<size_t,uint32_t> >::const_iterator it = pending[t].begin();
+            it != pending[t].end(); ++it )
+        {
+            memberIds[it->first].push_back( it->second );
+        }
+        pending[t].clear();
+    }
+    for( size_t c = 0; c < memberIds.size(); ++c ){
+        vector<uint32_t>& ids = memberIds[c];
+        if( ids.size() == oldSize[c] ) continue;
+        // the new tail is small compared to the sorted head
+        vector<uint32_t>::iterator mid = ids.begin() + oldSize[c];
+        sort( mid, ids.end() );
+        inplace_merge( ids.begin(), mid, ids.end() );
+        // a human may have been added several times
+        ids.erase( unique( ids.begin(), ids.end() ), ids.end() );
+    }
+}
+
+void SubPopIndex::members( ComponentId id, const Population& population,
+                           vector<size_t>& indices )
+{
+    assert( isTracked( id ) );
+    merge();
+    vector<uint32_t>& ids = memberIds[id.id];
+    indices.clear();
+    size_t w = 0;
+    for( size_t r = 0; r < ids.size(); ++r ){
+        size_t i;
+        if( population.findHuman( ids[r], i ) && population.human( i ).isInSubPop( id ) ){
+            indices.push_back( i );
+            ids[w] = ids[r];
+            ++w;
+        }
+        // else: human has died or left the sub-population; only a new
+        // deployment (calling add()) can make it a member again
+    }
+    ids.resize( w );
+}
+
+void SubPopIndex::rebuild( const Population& population ){
+    for( size_t t = 0; t < pending.size(); ++t )
+        pending[t].clear();
+    for( size_t c = 0; c < memberIds.size(); ++c ){
+        memberIds[c].clear();
+        if( !tracked[c] ) continue;
+        size_t i = 0;
+        for( Population::ConstIter it = population.cbegin(); it != population.cend(); ++it, ++i ){
+            if( it->isInSubPop( ComponentId( c ) ) )
+                memberIds[c].push_back( population.humanId( i ) );
+        }
+    }
+}
+
+} }
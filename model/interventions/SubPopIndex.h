@@ -0,0 +1,87 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_interventions_SubPopIndex
+#define Hmod_interventions_SubPopIndex
+
+#include "Global.h"
+#include "interventions/Interfaces.hpp"
+#include "util/parallel.h"
+
+class SubPopIndexSuite;
+namespace OM {
+    class Population;
+namespace interventions {
+
+/** Index of the members of those sub-populations to which timed deployments
+ * are restricted, allowing these deployments to visit only members instead of
+ * the whole population.
+ * 
+ * Members are stored by human identifier (see Host::Human::id()). Additions
+ * are recorded when they happen (see Host::Human::reportDeployment()), from
+ * any thread. Removals (expiry, removal on first event, death) are not:
+ * entries are checked against Host::Human::isInSubPop() and dropped when
+ * members() is called. The index is not checkpointed but rebuilt from the
+ * humans when loading (see rebuild()). */
+class SubPopIndex {
+public:
+    /** Index sub-population id. Call during initialisation only (after
+     * util::parallel::init()). */
+    static void track( ComponentId id );
+    
+    /// True if sub-population id is indexed.
+    static inline bool isTracked( ComponentId id ){
+        return id.id < tracked.size() && tracked[id.id];
+    }
+    
+    /** Record that the human with identifier humanId joined sub-population
+     * id, which must be tracked. May be called during parallel updates. */
+    static inline void add( ComponentId id, uint32_t humanId ){
+        pending[util::parallel::threadIndex()].push_back( make_pair( id.id, humanId ) );
+    }
+    
+    /** Set indices to the population indices (see Population::human()) of
+     * current members of sub-population id, which must be tracked, in
+     * population order. Must not be called during updates. */
+    static void members( ComponentId id, const Population& population,
+                         vector<size_t>& indices );
+    
+    /** Re-index all tracked sub-populations from the population (after
+     * loading a checkpoint). */
+    static void rebuild( const Population& population );
+    
+private:
+    /// Move pending additions into memberIds, keeping lists sorted
+    static void merge();
+    
+    // Whether each ComponentId (by index) is tracked
+    static vector<bool> tracked;
+    // For each ComponentId (by index): sorted identifiers of humans who are
+    // or were members
+    static vector<vector<uint32_t> > memberIds;
+    // Per thread: additions (ComponentId index, human identifier) not yet
+    // merged into memberIds
+    static vector<vector<pair<size_t,uint32_t> > > pending;
+    
+    friend class ::SubPopIndexSuite;
+};
+
+} }
+#endif
@@ -49,6 +49,13 @@ void initMainSim();
 /// Call after all data for some survey number has been provided
 void concludeSurvey();
 
+/** Add reports made by threads other than the first during a parallel human
+ * update into the main stores (in thread order, so that totals are
+ * reproducible). Only surveys reported to since the last call are merged.
+ * Must be called outside of parallel regions; does nothing when not
+ * threaded. */
+void mergeThreadReports();
+
 /// Write survey data to output.txt (or configured file)
 void writeSurveyData();
 
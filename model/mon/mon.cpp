@@ -27,6 +27,7 @@
 #include "Clinical/CaseManagementCommon.h"
 #include "Host/Human.h"
 #include "util/errors.h"
+#include "util/parallel.h"
 #include "schema/scenario.h"
 
 #include <FastDelegate.h>
@@ -70,6 +71,12 @@ class Store{
     size_t nAgeGroups, nCohortSets, nSpecies, nGenotypes, nDrugs;
     // These are the stored reports (multidimensional; use size() and index())
     vector<T> reports;
+    // Reports from threads 1, 2, ... during parallel updates (thread 0 uses
+    // reports directly). Same layout as reports; zeroed after merging.
+    vector<vector<T> > threadReports;
+    // For each of threadReports: first and last survey with unmerged reports
+    // (first > last if there are none)
+    vector<pair<size_t,size_t> > threadSurveys;
     
     // get size of reports
     inline size_t size(){ return outMeasures.size() * impl::nSurveys *
@@ -107,7 +114,16 @@ class Store{
                 << endl;
         }
 #endif
-        reports[index(mIndex,survey,ageIndex,cohortSet,species,genotype,drug)] += val;
+        const size_t i = index(mIndex,survey,ageIndex,cohortSet,species,genotype,drug);
+        const size_t thread = util::parallel::threadIndex();
+        if( thread == 0 ){
+            reports[i] += val;
+        }else{
+            threadReports[thread-1][i] += val;
+            pair<size_t,size_t>& surveys = threadSurveys[thread-1];
+            surveys.first = min( surveys.first, survey );
+            surveys.second = max( surveys.second, survey );
+        }
     }
     
     void writeM( ostream& stream, size_t survey, int outMeasure, size_t inMeasure ){
@@ -209,6 +225,29 @@ public:
         }
         
         reports.assign(size(), 0);
+        threadReports.assign(util::parallel::numThreads() - 1, reports);
+        threadSurveys.assign(threadReports.size(), make_pair(NOT_USED, size_t(0)));
+    }
+    
+    // Add per-thread reports into reports, in thread order. Only the surveys
+    // each thread reported to are visited (usually just the current one).
+    void mergeThreads(){
+        // reports of one measure and survey are contiguous:
+        const size_t sliceLen = nAgeGroups * nCohortSets * nSpecies * nGenotypes * nDrugs;
+        for( size_t t = 0; t < threadReports.size(); ++t ){
+            pair<size_t,size_t>& surveys = threadSurveys[t];
+            if( surveys.first > surveys.second ) continue;      // nothing reported
+            vector<T>& tr = threadReports[t];
+            for( size_t m = 0; m < outMeasures.size(); ++m ){
+                const size_t begin = index( m, surveys.first, 0, 0, 0, 0, 0 );
+                const size_t end = index( m, surveys.second, 0, 0, 0, 0, 0 ) + sliceLen;
+                for( size_t i = begin; i < end; ++i ){
+                    reports[i] += tr[i];
+                    tr[i] = 0;
+                }
+            }
+            surveys = make_pair( NOT_USED, size_t(0) );
+        }
     }
     
     // Take a reported value and either store it or forget it.
@@ -453,6 +492,37 @@ void internal::initReporting( const scnXml::Scenario& scenario ){
     storeSGF.init( enabledOutMeasures, nSpecies, nDrugs );
 }
 
+void mergeThreadReports(){
+    if( util::parallel::numThreads() == 1 ) return;
+    storeI.mergeThreads();
+    storeAI.mergeThreads();
+    storeCI.mergeThreads();
+    storeACI.mergeThreads();
+    storeGI.mergeThreads();
+    storeAGI.mergeThreads();
+    storeCGI.mergeThreads();
+    storeACGI.mergeThreads();
+    storePI.mergeThreads();
+    storeAPI.mergeThreads();
+    storeCPI.mergeThreads();
+    storeACPI.mergeThreads();
+    
+    storeF.mergeThreads();
+    storeAF.mergeThreads();
+    storeCF.mergeThreads();
+    storeACF.mergeThreads();
+    storeGF.mergeThreads();
+    storeAGF.mergeThreads();
+    storeCGF.mergeThreads();
+    storeACGF.mergeThreads();
+    storePF.mergeThreads();
+    storeAPF.mergeThreads();
+    storeCPF.mergeThreads();
+    storeACPF.mergeThreads();
+    storeSF.mergeThreads();
+    storeSGF.mergeThreads();
+}
+
 void internal::write( ostream& stream ){
     // use a (tree) map to sort by external measure
     typedef pair<WriteDelegate,size_t> MPair;
@@ -506,7 +576,8 @@ void internal::write( ostream& stream ){
 void reportMI( Measure measure, int val ){
     storeI.report( val, measure, impl::currentSurvey, 0, 0, 0, 0, 0 );
 }
-void reportMHI( Measure measure, const Host::Human& human, int val ){
+void reportMHI( Measure measure, const Host::Human& human, int value ){
+    const int val = value * human.weight();
     const size_t survey = impl::currentSurvey;
     const size_t ageIndex = human.monAgeGroup().i();
     storeI.report( val, measure, survey, 0, 0, 0, 0, 0 );
@@ -523,8 +594,9 @@ void reportMSACI( Measure measure, size_t survey,
     storeACI.report( val, measure, survey, ageGroup.i(), cohortSet, 0, 0, 0 );
 }
 void reportMHGI( Measure measure, const Host::Human& human, size_t genotype,
-                 int val )
+                 int value )
 {
+    const int val = value * human.weight();
     const size_t survey = impl::currentSurvey;
     const size_t ageIndex = human.monAgeGroup().i();
     storeI.report( val, measure, survey, 0, 0, 0, 0, 0 );
@@ -537,8 +609,9 @@ void reportMHGI( Measure measure, const Host::Human& human, size_t genotype,
     storeACGI.report( val, measure, survey, ageIndex, human.cohortSet(), 0, genotype, 0 );
 }
 void reportMHPI( Measure measure, const Host::Human& human, size_t drugIndex,
-                int val )
+                int value )
 {
+    const int val = value * human.weight();
     const size_t survey = impl::currentSurvey;
     const size_t ageIndex = human.monAgeGroup().i();
     storeI.report( val, measure, survey, 0, 0, 0, 0, 0 );
@@ -555,7 +628,8 @@ void reportMHPI( Measure measure, const Host::Human& human, size_t drugIndex,
 void reportMHD( Measure measure, const Host::Human& human,
                 Deploy::Method method )
 {
-    const int val = 1;  // always report 1 deployment
+    // always report 1 deployment per person represented
+    const int val = human.weight();
     const size_t survey = impl::currentSurvey;
     size_t ageIndex = human.monAgeGroup().i();
     storeI.deploy( val, measure, survey, 0, 0, method );
@@ -573,7 +647,8 @@ void reportMHD( Measure measure, const Host::Human& human,
 void reportMF( Measure measure, double val ){
     storeF.report( val, measure, impl::currentSurvey, 0, 0, 0, 0, 0 );
 }
-void reportMHF( Measure measure, const Host::Human& human, double val ){
+void reportMHF( Measure measure, const Host::Human& human, double value ){
+    const double val = value * human.weight();
     const size_t survey = impl::currentSurvey;
     const size_t ageIndex = human.monAgeGroup().i();
     storeF.report( val, measure, survey, 0, 0, 0, 0, 0 );
@@ -594,7 +669,8 @@ void reportMACGF( Measure measure, size_t ageIndex, uint32_t cohortSet,
     storeCGF.report( val, measure, survey, 0, cohortSet, 0, genotype, 0 );
     storeACGF.report( val, measure, survey, ageIndex, cohortSet, 0, genotype, 0 );
 }
-void reportMHPF( Measure measure, const Host::Human& human, size_t drug, double val ){
+void reportMHPF( Measure measure, const Host::Human& human, size_t drug, double value ){
+    const double val = value * human.weight();
     const size_t survey = impl::currentSurvey;
     const size_t ageIndex = human.monAgeGroup().i();
     storeF.report( val, measure, survey, 0, 0, 0, 0, 0 );
@@ -610,7 +686,7 @@ void reportMHGF( Measure measure, const Host::Human& human, size_t genotype,
                  double val )
 {
     reportMACGF( measure, human.monAgeGroup().i(), human.cohortSet(),
-                 genotype, val );
+                 genotype, val * human.weight() );
 }
 void reportMSF( Measure measure, size_t species, double val ){
     const size_t survey = impl::currentSurvey;
@@ -192,6 +192,8 @@ void reportMI( Measure measure, int val );
 /// Report some value (floating point) to the current survey.
 void reportMF( Measure measure, double val );
 /// Report some value (integer) for some human to the current survey.
+///
+/// Functions taking a human scale the value by Human::weight().
 void reportMHI( Measure measure, const Host::Human& human, int val );
 /// Report some value (integer) for some survey, age group and cohort set
 void reportMSACI( Measure measure, size_t survey, AgeGroup ageGroup,
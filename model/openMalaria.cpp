@@ -24,6 +24,7 @@
 #include "Global.h"
 #include "Simulator.h"
 #include "util/CommandLine.h"
+#include "util/batch.h"
 #include "util/errors.h"
 
 #include <cstdio>
@@ -42,6 +43,10 @@ int main(int argc, char* argv[]) {
         
         scenarioFile = util::CommandLine::parse (argc, argv);   // parse arguments
         
+        // In batch mode, only child processes return, each with one entry
+        if( util::CommandLine::getBatchName() != "" )
+            scenarioFile = util::batch::forkEntries();
+        
         util::BoincWrapper::init();     // BOINC init
         
         // Load the scenario document:
@@ -50,7 +55,7 @@ int main(int argc, char* argv[]) {
         util::Checksum cksum = documentLoader.loadDocument(scenarioFile);
         
         // Set up the simulator
-        Simulator simulator( cksum, documentLoader.document() );
+        Simulator simulator( cksum, documentLoader.warmupChecksum(), documentLoader.document() );
         
         // Save changes to the document if any occurred.
         documentLoader.saveDocument();
@@ -60,7 +65,7 @@ int main(int argc, char* argv[]) {
         
         // Write scenario checksum, only if simulation completed.
         // Writing it earlier breaks checkpointing.
-        cksum.writeToFile (util::BoincWrapper::resolveFile ("scenario.sum"));
+        cksum.writeToFile (util::BoincWrapper::resolveFile (util::CommandLine::getChecksumName()));
         
         // We call boinc_finish before cleanup since it should help ensure
         // app isn't killed between writing output.txt and calling boinc_finish,
@@ -297,8 +297,10 @@ namespace OM { namespace util {
     
     // -----  AgeGroupInterpolator  -----
     
+    bool AgeGroupInterpolator::tabulateTables = false;
+    
     AgeGroupInterpolator::AgeGroupInterpolator() :
-        obj(&AgeGroupDummy::singleton) {}
+        obj(&AgeGroupDummy::singleton), stepsPerYear(0.0) {}
     
     void AgeGroupInterpolator::set(
         const scnXml::AgeGroupValues& ageGroups, const char* eltName
@@ -313,6 +315,22 @@ namespace OM { namespace util {
         }else{
             throw util::xml_scenario_error( (boost::format( "age group interpolation %1% not implemented" ) %interp).str() );
         }
+        tabulate();
+    }
+    void AgeGroupInterpolator::setTabulate( bool tabulate ){
+        tabulateTables = tabulate;
+    }
+    void AgeGroupInterpolator::tabulate(){
+        if( !tabulateTables )
+            return;
+        // Human ages are whole numbers of steps; a step beyond the maximum
+        // age is included since some ages are taken at the end of a step.
+        size_t n = sim::maxHumanAge().inSteps() + 2;
+        table.resize( n );
+        for( size_t i = 0; i < n; ++i ){
+            table[i] = obj->eval( sim::fromTS( static_cast<int>(i) ).inYears() );
+        }
+        stepsPerYear = 1.0 / sim::oneTS().inYears();
     }
     void AgeGroupInterpolator::reset(){
         assert( obj != NULL );  // should not do that
@@ -320,6 +338,7 @@ namespace OM { namespace util {
             delete obj;
             obj = &AgeGroupDummy::singleton;
         }
+        table.clear();
     }
     bool AgeGroupInterpolator::isSet()    {
         return obj != &AgeGroupDummy::singleton;
@@ -47,8 +47,11 @@ protected:
 /** A class representing deterministic interpolation of data collected
  * according to age groups. Derived classes implement the actual interpolation.
  * 
- * Current version does not store an age index, thus an order log(n) lookup
- * must occur each time a value is looked up.
+ * By default an order log(n) lookup must occur each time a value is looked
+ * up. With --tabulate-age-groups, values at each whole number of time steps
+ * up to the maximum human age are computed in advance and ages matching one
+ * of these exactly (as human ages do) are looked up in this table; other
+ * ages fall back to the usual lookup.
  ********************************************/
 struct AgeGroupInterpolator
 {
@@ -69,14 +72,25 @@ struct AgeGroupInterpolator
     /// Return true if set() was ever called.
     bool isSet();
     
+    /** Enable or disable tabulation (--tabulate-age-groups) for
+     * interpolators set or scaled after this call. */
+    static void setTabulate( bool tabulate );
+    
     /** Return a value interpolated for age ageYears. */
     inline double eval( double ageYears )const{
+        double steps = ageYears * stepsPerYear + 0.5;
+        if( steps >= 0.0 && steps < table.size() ){
+            int i = static_cast<int>( steps );
+            if( sim::fromTS( i ).inYears() == ageYears )
+                return table[i];
+        }
         return obj->eval( ageYears );
     }
     
     /** Scale function by factor. */
     inline void scale( double factor ){
         obj->scale( factor );
+        tabulate();
     }
 
     /** Find the youngest age which is the global maximum (i.e. the age at
@@ -87,7 +101,17 @@ struct AgeGroupInterpolator
     }
     
 private:
+    /** Fill table, if enabled by setTabulate(). */
+    void tabulate();
+    
+    static bool tabulateTables;
+    
     AgeGroupInterpolation *obj;
+    
+    /** Value at age i time steps (for i up to the maximum human age), or
+     * empty if not tabulated. */
+    vector<double> table;
+    double stepsPerYear;
 };
 
 } }
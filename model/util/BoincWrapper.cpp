@@ -183,7 +183,7 @@ Checksum Checksum::generate (istream& fileStream) {
 void Checksum::writeToFile (string filename) {
     ifstream test (filename.c_str());
     if (test.is_open())
-	throw util::base_exception("File scenario.sum exists!",Error::Checksum);
+	throw util::base_exception("File "+filename+" exists!",Error::Checksum);
     
     // Use C file commands, since these have clearer behaviour with binary data:
     FILE *f = fopen( filename.c_str(), "wb" );
@@ -192,7 +192,7 @@ void Checksum::writeToFile (string filename) {
 	written=fwrite( data, 1, 16, f );
     fclose( f );
     if( written != 16 )
-	throw util::base_exception("Error writing scenario.sum",Error::Checksum);
+	throw util::base_exception("Error writing "+filename,Error::Checksum);
 }
 #endif	// Without/with BOINC
 
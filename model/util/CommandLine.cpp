@@ -37,6 +37,16 @@ namespace OM { namespace util {
     string CommandLine::resourcePath;
     string CommandLine::outputName;
     string CommandLine::ctsoutName;
+    string CommandLine::phaseTimesName;
+    string CommandLine::checksumName = "scenario.sum";
+    string CommandLine::profileName = "profile.txt";
+    string CommandLine::saveWarmupName;
+    string CommandLine::loadWarmupName;
+    bool CommandLine::warmupOnly = false;
+    string CommandLine::batchName;
+    size_t CommandLine::batchJobs = 1;
+    size_t CommandLine::numThreads = 1;
+    uint32_t CommandLine::humanWeight = 1;
     set<SimTime> CommandLine::checkpoint_times;
     
     string parseNextArg (int argc, char* argv[], int& i) {
@@ -85,6 +95,26 @@ namespace OM { namespace util {
                         throw cmd_exception ("--ctsout argument may only be given once");
                     }
                     ctsoutName = parseNextArg (argc, argv, i);
+                } else if (clo == "phase-times") {
+                    if (phaseTimesName != ""){
+                        throw cmd_exception ("--phase-times argument may only be given once");
+                    }
+                    phaseTimesName = parseNextArg (argc, argv, i);
+                } else if (clo == "save-warmup") {
+                    if (saveWarmupName != ""){
+                        throw cmd_exception ("--save-warmup argument may only be given once");
+                    }
+                    saveWarmupName = parseNextArg (argc, argv, i);
+                } else if (clo == "load-warmup") {
+                    if (loadWarmupName != ""){
+                        throw cmd_exception ("--load-warmup argument may only be given once");
+                    }
+                    loadWarmupName = parseNextArg (argc, argv, i);
+                } else if (clo == "batch") {
+                    if (batchName != ""){
+                        throw cmd_exception ("--batch argument may only be given once");
+                    }
+                    batchName = parseNextArg (argc, argv, i);
                 } else if (clo == "name") {
                     if (ctsoutName != "" || outputName != "" || scenarioFile != ""){
                         throw cmd_exception ("--name may not be used along with --scenario, --output or --ctsout");
@@ -93,6 +123,7 @@ namespace OM { namespace util {
                     (scenarioFile = "scenario").append(name).append(".xml");
                     (outputName = "output").append(name).append(".txt");
                     (ctsoutName = "ctsout").append(name).append(".txt");
+                    (profileName = "profile").append(name).append(".txt");
                 } else if (clo == "validate-only") {
                     options.set (SKIP_SIMULATION);
                 } else if (clo == "deprecation-warnings") {
@@ -133,6 +164,53 @@ namespace OM { namespace util {
 			break;
 		    }
 		    options[COMPRESS_CHECKPOINTS] = b;
+		} else if (clo.compare (0,8,"threads=") == 0) {
+		    stringstream t;
+		    t << clo.substr (8);
+		    int n;
+		    t >> n;
+		    if (t.fail() || n <= 0) {
+			cerr << "Expected: --threads=n  where n is a positive integer" << endl;
+			cloError = true;
+			break;
+		    }
+		    numThreads = n;
+		} else if (clo.compare (0,13,"human-weight=") == 0) {
+		    stringstream t;
+		    t << clo.substr (13);
+		    int n;
+		    t >> n;
+		    if (t.fail() || n <= 0) {
+			cerr << "Expected: --human-weight=n  where n is a positive integer" << endl;
+			cloError = true;
+			break;
+		    }
+		    humanWeight = n;
+		} else if (clo.compare (0,11,"batch-jobs=") == 0) {
+		    stringstream t;
+		    t << clo.substr (11);
+		    int n;
+		    t >> n;
+		    if (t.fail() || n <= 0) {
+			cerr << "Expected: --batch-jobs=n  where n is a positive integer" << endl;
+			cloError = true;
+			break;
+		    }
+		    batchJobs = n;
+		} else if (clo == "counter-rng") {
+		    options.set (COUNTER_RNG);
+		} else if (clo == "vector-molineaux") {
+		    options.set (VECTOR_MOLINEAUX);
+		} else if (clo == "vector-genotypes") {
+		    options.set (VECTOR_GENOTYPES);
+		} else if (clo == "tabulate-age-groups") {
+		    options.set (TABULATE_AGE_GROUPS);
+		} else if (clo == "tabulate-decay") {
+		    options.set (TABULATE_DECAY);
+		} else if (clo == "skip-idle-hosts") {
+		    options.set (SKIP_IDLE_HOSTS);
+		} else if (clo == "async-checkpoints") {
+		    options.set (ASYNC_CHECKPOINTS);
 		} else if (clo == "checkpoint-duplicates") {
 		    options.set (TEST_DUPLICATE_CHECKPOINTS);
                 } else if (clo == "debug-vector-fitting") {
@@ -180,6 +258,7 @@ namespace OM { namespace util {
                         (scenarioFile = "scenario").append(name).append(".xml");
                         (outputName = "output").append(name).append(".txt");
                         (ctsoutName = "ctsout").append(name).append(".txt");
+                        (profileName = "profile").append(name).append(".txt");
 		    } else if (clo[j] == 'c') {
 			options.set (TEST_CHECKPOINTING);
 		    } else if (clo[j] == 'd') {
@@ -221,12 +300,76 @@ namespace OM { namespace util {
 	    << "			If path is relative (doesn't start '/'), --resource-path is used."<<endl
 	    << " -o --output file.txt	Uses file.txt as output file name. If not given, output.txt is used." << endl
 	    << "    --ctsout file.txt	Uses file.txt as ctsout file name. If not given, ctsout.txt is used." << endl
+	    << "    --phase-times file.txt" << endl
+	    << "			Write the wall-clock time spent in each simulation phase to" << endl
+	    << "			file.txt at the end of the run (only for the part of the run" << endl
+	    << "			done by this process when resuming from a checkpoint)." << endl
 	    << " -n --name NAME		Equivalent to --scenario scenarioNAME.xml --output outputNAME.txt \\"<<endl
-	    << "			--ctsout ctsoutNAME.txt" <<endl
+	    << "			--ctsout ctsoutNAME.txt (and writes any profile to" <<endl
+	    << "			profileNAME.txt)" <<endl
+	    << "    --save-warmup file	Save the simulation state at the end of the warm-up (before" << endl
+	    << "			the main phase) to file, then continue. Compressed if the" << endl
+	    << "			name ends .gz." << endl
+	    << "    --load-warmup file	Start the main phase from a state saved with --save-warmup," << endl
+	    << "			instead of simulating the warm-up. The scenario may differ" << endl
+	    << "			from that used to save the state only in its interventions" << endl
+	    << "			and monitoring elements and root element attributes;" << endl
+	    << "			command-line options should be the same. Continuous outputs" << endl
+	    << "			during initialisation are not written." << endl
+	    << "    --batch manifest.txt" << endl
+	    << "			Run each scenario listed in manifest.txt: one entry per line," << endl
+	    << "			\"NAME [file.xml]\", run as with --name NAME (and --scenario" << endl
+	    << "			file.xml if given). Other options apply to all entries. Each" << endl
+	    << "			entry is run by a child process forked after start-up." << endl
+	    << "			Unless --load-warmup is given, entries whose scenarios differ" << endl
+	    << "			only as allowed by --load-warmup share one simulated warm-up" << endl
+	    << "			(see --save-warmup; the snapshot file warmupNAME.snapshot," << endl
+	    << "			named after the first such entry, is removed afterwards)." << endl
+	    << "			Each entry still reads and initialises its scenario itself;" << endl
+	    << "			only the warm-up simulation is shared." << endl
+	    << "			Not available on Windows or in BOINC builds." << endl
+	    << "    --batch-jobs=n	Run up to n batch entries concurrently (default 1)." << endl
 	    << "    --validate-only	Initialise and validate scenario, but don't run simulation." << endl
 	    << "    --deprecation-warnings" << endl
 	    << "			Warn about the use of features deemed error-prone and where" << endl
 	    << "			more flexible alternatives are available." << endl
+	    << "    --threads=n		Update humans using n threads (default 1). Requires a build with" << endl
+	    << "			OM_OPENMP. Results are reproducible for a fixed n but differ" << endl
+	    << "			from those with another number of threads. Mosquito species" << endl
+	    << "			(and many parasite genotypes) are also updated concurrently;" << endl
+	    << "			this does not affect results." << endl
+	    << "    --human-weight=n	Let each simulated human represent a cohort of n identical" << endl
+	    << "			people (default 1). The population size given in the scenario" << endl
+	    << "			is the number of people represented; outputs count people." << endl
+	    << "			This reduces run-time and memory by roughly a factor n, at the" << endl
+	    << "			cost of stochastic resolution." << endl
+	    << "    --counter-rng	Use a counter-based random number generator, giving each human" << endl
+	    << "			independent random streams. Random draws then don't depend on" << endl
+	    << "			--threads (sums merged across threads may still differ due to" << endl
+	    << "			rounding). Results differ from those of the default generator." << endl
+	    << "    --vector-molineaux	Update Molineaux infections with a kernel which compilers can" << endl
+	    << "			vectorise. Results differ slightly from those of the default" << endl
+	    << "			kernel, since sums are accumulated in a different order." << endl
+	    << "    --vector-genotypes	Update mosquito transmission with a kernel which compilers can" << endl
+	    << "			vectorise across parasite genotypes. Results differ from those" << endl
+	    << "			of the default kernel by rounding error." << endl
+	    << "    --tabulate-age-groups" << endl
+	    << "			Look up age-group data (e.g. body mass, availability to" << endl
+	    << "			mosquitoes) in tables by age in time steps instead of searching" << endl
+	    << "			the age groups. Results are unchanged; uses more memory." << endl
+	    << "    --tabulate-decay	Evaluate exponential, Weibull, Hill and smooth-compact decay" << endl
+	    << "			of interventions by interpolating tabulated values. Results" << endl
+	    << "			differ slightly: tables are built such that interpolated" << endl
+	    << "			decay values are within 1e-6 of exact ones at the quarter" << endl
+	    << "			points of each table step (functions for which this fails," << endl
+	    << "			e.g. Hill with k < 2, are not tabulated)." << endl
+	    << "    --skip-idle-hosts	Skip infection incidence of hosts without exposure and the" << endl
+	    << "			clinical update of hosts without parasites, drugs or pending" << endl
+	    << "			clinical events, which would only draw random numbers; the" << endl
+	    << "			decay of the pyrogenic threshold is applied when next needed." << endl
+	    << "			Immunity decay is still updated every step. Results differ" << endl
+	    << "			since random streams change. Has no effect with the event" << endl
+	    << "			scheduler or non-malaria fevers." << endl
 	    << endl
 	    << "Debugging options:"<<endl
 	    << " -m --print-model	Print all model options with a non-default value and exit." << endl
@@ -246,6 +389,9 @@ namespace OM { namespace util {
 	    << "			identical to that read." <<endl
 	    << "    --compress-checkpoints=boolean" << endl
 	    << "			Set checkpoint compression on or off. Default is on." <<endl
+	    << "    --async-checkpoints" << endl
+	    << "			Write checkpoints to disk in a background thread while the" << endl
+	    << "			simulation continues (uses memory for a copy of the state)." << endl
 	    << "    --debug-vector-fitting"<<endl
 	    << "			Show details of vector-parameter fitting. The fitting methods used" <<endl
 	    << "			aren't guaranteed to work. If they don't, this output should help"<<endl
@@ -272,6 +418,17 @@ namespace OM { namespace util {
 	
 	if (checkpoint_times.size())	// timed checkpointing overrides this
 	    options[TEST_CHECKPOINTING] = false;
+	
+	if (saveWarmupName != "" && loadWarmupName != "")
+	    throw cmd_exception ("--save-warmup may not be used along with --load-warmup");
+	
+	if (batchName != ""){
+	    // entries would share (and overwrite) one another's files
+	    if (scenarioFile != "" || outputName != "" || ctsoutName != "" || phaseTimesName != "")
+		throw cmd_exception ("--batch may not be used along with --scenario, --output, --ctsout, --phase-times or --name");
+	    if (options[TEST_CHECKPOINTING] || checkpoint_times.size() || saveWarmupName != "")
+		throw cmd_exception ("--batch may not be used along with --checkpoint or --save-warmup");
+	}
         
         if (scenarioFile == ""){
             scenarioFile = "scenario.xml";
@@ -290,6 +447,22 @@ namespace OM { namespace util {
 	return scenarioFile;
     }
     
+    void CommandLine::setBatchEntry (const string& name) {
+	(outputName = "output").append(name).append(".txt");
+	(ctsoutName = "ctsout").append(name).append(".txt");
+	(checksumName = "scenario").append(name).append(".sum");
+	(profileName = "profile").append(name).append(".txt");
+    }
+    
+    void CommandLine::setBatchWarmup (const string& fileName, bool save) {
+	if (save){
+	    saveWarmupName = fileName;
+	    warmupOnly = true;
+	}else{
+	    loadWarmupName = fileName;
+	}
+    }
+    
     string CommandLine::lookupResource (const string& path) {
 	string ret;
 	if (path.size() >= 1 && path[0] == '/') {
@@ -309,14 +482,19 @@ namespace OM { namespace util {
     void CommandLine::staticCheckpoint (istream& stream) {
 	string tOpt;
 	string tResPath;
+	uint32_t tWeight;
 	tOpt & stream;
 	tResPath & stream;
+	tWeight & stream;
 	assert (tOpt == options.to_string());
 	assert (tResPath == resourcePath);
+	if (tWeight != humanWeight)
+	    throw checkpoint_error ("--human-weight differs from that used when writing the checkpoint");
     }
     void CommandLine::staticCheckpoint (ostream& stream) {
 	options.to_string() & stream;
 	resourcePath & stream;
+	humanWeight & stream;
     }
     
 } }
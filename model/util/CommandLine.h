@@ -63,6 +63,28 @@ namespace OM { namespace util {
             /** Warn on use of deprecated features; that is recommend the use
              * of replacement features. */
             DEPRECATION_WARNINGS,
+            /** Use the counter-based random number generator (see
+             * util::random::useCounterGenerator()). */
+            COUNTER_RNG,
+            /** Serialise checkpoints to memory then write them to disk in a
+             * background thread while the simulation continues. */
+            ASYNC_CHECKPOINTS,
+            /** Use the vectorised kernel for Molineaux infections (see
+             * WithinHost::MolineauxInfection::setVectorKernel()). */
+            VECTOR_MOLINEAUX,
+            /** Use the vectorised per-genotype update of mosquito
+             * transmission (see MosqTransmission::setVectorKernel()). */
+            VECTOR_GENOTYPES,
+            /** Tabulate age-group interpolators by age in time steps (see
+             * AgeGroupInterpolator::setTabulate()). */
+            TABULATE_AGE_GROUPS,
+            /** Evaluate smooth decay functions by interpolating tables (see
+             * DecayFunction::tabulate()). */
+            TABULATE_DECAY,
+            /** Skip incidence without exposure and the clinical update of
+             * hosts without parasites, drugs or pending clinical events (see
+             * Host::Human::update()). */
+            SKIP_IDLE_HOSTS,
 	    NUM_OPTIONS
 	};
 	
@@ -96,6 +118,75 @@ namespace OM { namespace util {
             return ctsoutName;
         }
         
+        /** Get the name of the file to write per-phase run times to, or an
+         * empty string if these shouldn't be written. */
+        static inline string getPhaseTimesName (){
+            return phaseTimesName;
+        }
+        
+        /** Get the name of the file to write the scenario checksum to
+         * (scenario.sum, or scenarioNAME.sum for batch entry NAME). */
+        static inline string getChecksumName (){
+            return checksumName;
+        }
+        
+        /** Get the name of the file to write the run-time profile to
+         * (profile.txt, or profileNAME.txt with --name or batch entry NAME;
+         * see util/profile.h). */
+        static inline string getProfileName (){
+            return profileName;
+        }
+        
+        /** Get the name of the file to save a warm-up snapshot to, or an
+         * empty string if none should be saved. */
+        static inline string getSaveWarmupName (){
+            return saveWarmupName;
+        }
+        
+        /** Get the name of the warm-up snapshot to start from, or an empty
+         * string if the warm-up should be simulated. */
+        static inline string getLoadWarmupName (){
+            return loadWarmupName;
+        }
+        
+        /** Get the name of the batch manifest (see util/batch.h), or an
+         * empty string if not running in batch mode. */
+        static inline string getBatchName (){
+            return batchName;
+        }
+        
+        /** Get the maximum number of batch entries to run concurrently. */
+        static inline size_t getBatchJobs (){
+            return batchJobs;
+        }
+        
+        /** Set output file names for batch entry name, as with --name. */
+        static void setBatchEntry (const string& name);
+        
+        /** Set by batch mode to share a warm-up between entries: if save,
+         * write a warm-up snapshot to fileName then stop (see
+         * getWarmupOnly()); otherwise start from that snapshot, as with
+         * --load-warmup. */
+        static void setBatchWarmup (const string& fileName, bool save);
+        
+        /** True if the simulation should stop once the warm-up snapshot has
+         * been written (only set by batch mode). */
+        static inline bool getWarmupOnly (){
+            return warmupOnly;
+        }
+        
+        /** Get the number of threads to use for the human update (1 unless
+         * --threads was given). */
+        static inline size_t getNumThreads (){
+            return numThreads;
+        }
+        
+        /** Get the number of people each simulated human represents (1
+         * unless --human-weight was given). */
+        static inline uint32_t getHumanWeight (){
+            return humanWeight;
+        }
+        
 	/** Looks through all command line options.
 	*
 	* @returns The name of the scenario XML file to use.
@@ -122,6 +213,24 @@ namespace OM { namespace util {
 	//Output filename (for main output file "output.txt")
 	static string outputName;
         static string ctsoutName;
+        static string phaseTimesName;
+        static string checksumName;
+        static string profileName;
+        
+        // Warm-up snapshot to save or load (see Simulator)
+        static string saveWarmupName;
+        static string loadWarmupName;
+        static bool warmupOnly;
+        
+        // Batch manifest and number of concurrent batch entries
+        static string batchName;
+        static size_t batchJobs;
+        
+        // Number of threads to update humans with
+        static size_t numThreads;
+        
+        // Number of people represented by each human
+        static uint32_t humanWeight;
 	
 	/** Set of simulation times at which a checkpoint should be written and
 	* program should exit (to allow resume). */
@@ -22,6 +22,7 @@
 #include "util/errors.h"
 #include "util/StreamValidator.h"
 #include "util/random.h"
+#include "util/CommandLine.h"
 
 #include <cmath>
 #include <stdexcept>
@@ -246,28 +247,70 @@ private:
 
 // -----  interface / static functions  -----
 
+/// Accuracy of tabulated decay functions (see DecayFunction::tabulate())
+const double TABLE_TOLERANCE = 1e-6;
+/// Limit on number of steps of a table
+const size_t TABLE_MAX_STEPS = 1 << 16;
+
+void DecayFunction::tabulate(){
+    double end = 1.0;
+    while( end < 64.0 && eval( end ) >= TABLE_TOLERANCE )
+        end *= 2.0;
+    
+    for( size_t n = 256; n <= TABLE_MAX_STEPS; n *= 2 ){
+        const double step = end / n;
+        table.resize( n + 1 );
+        for( size_t i = 0; i <= n; ++i )
+            table[i] = eval( i * step );
+        // check quarter points of each step: where curvature varies within
+        // a step, the interpolation error need not peak at the middle
+        bool accurate = true;
+        for( size_t i = 0; i < n && accurate; ++i ){
+            for( size_t j = 1; j < 4 && accurate; ++j ){
+                const double x = 0.25 * j;
+                const double interp = table[i] + x * (table[i+1] - table[i]);
+                accurate = fabs( interp - eval( (i + x) * step ) ) <= TABLE_TOLERANCE;
+            }
+        }
+        if( accurate ){
+            tableEnd = end;
+            invTableStep = n / end;
+            return;
+        }
+    }
+    // interpolation not accurate enough (e.g. infinite gradient at 0)
+    table.clear();
+}
+
 auto_ptr<DecayFunction> DecayFunction::makeObject(
     const scnXml::DecayFunction& elt, const char* eltName
 ){
     // Type mostly equivalent to a std::string:
     const scnXml::Function& func = elt.getFunction();
+    // These are cheap to evaluate (and not smooth), so are never tabulated:
     if( func == "constant" ){
         return auto_ptr<DecayFunction>(new ConstantDecayFunction);
     }else if( func == "step" ){
         return auto_ptr<DecayFunction>(new StepDecayFunction( elt ));
     }else if( func == "linear" ){
         return auto_ptr<DecayFunction>(new LinearDecayFunction( elt ));
-    }else if( func == "exponential" ){
-        return auto_ptr<DecayFunction>(new ExponentialDecayFunction( elt ));
+    }
+    
+    auto_ptr<DecayFunction> ret;
+    if( func == "exponential" ){
+        ret = auto_ptr<DecayFunction>(new ExponentialDecayFunction( elt ));
     }else if( func == "weibull" ){
-        return auto_ptr<DecayFunction>(new WeibullDecayFunction( elt ));
+        ret = auto_ptr<DecayFunction>(new WeibullDecayFunction( elt ));
     }else if( func == "hill" ){
-        return auto_ptr<DecayFunction>(new HillDecayFunction( elt ));
+        ret = auto_ptr<DecayFunction>(new HillDecayFunction( elt ));
     }else if( func == "smooth-compact" ){
-        return auto_ptr<DecayFunction>(new SmoothCompactDecayFunction( elt ));
+        ret = auto_ptr<DecayFunction>(new SmoothCompactDecayFunction( elt ));
     }else{
         throw util::xml_scenario_error( (boost::format( "decay function type %1% of %2% unrecognized" ) %func %eltName).str() );
     }
+    if( util::CommandLine::option( util::CommandLine::TABULATE_DECAY ) )
+        ret->tabulate();
+    return ret;
 }
 auto_ptr<DecayFunction> DecayFunction::makeConstantObject(){
     return auto_ptr<DecayFunction>(new ConstantDecayFunction);
@@ -95,7 +95,13 @@ public:
      * over this period (from age-1 to age), but difference should be small for
      * interventions being effective for a month or more. */
     inline double eval( SimTime age, DecayFuncHet sample )const{
-        return eval( age.inDays() * sample.getTMult() );
+        double effectiveAge = age.inDays() * sample.getTMult();
+        if( effectiveAge >= 0.0 && effectiveAge < tableEnd ){
+            double pos = effectiveAge * invTableStep;
+            size_t i = static_cast<size_t>( pos );
+            return table[i] + (pos - i) * (table[i+1] - table[i]);
+        }
+        return eval( effectiveAge );
     }
     
     /** Sample a DecayFuncHet value (should be stored per individual).
@@ -119,10 +125,29 @@ public:
     virtual SimTime sampleAgeOfDecay () const =0;
     
 protected:
-    DecayFunction() {}
+    DecayFunction() : tableEnd(0.0), invTableStep(0.0) {}
     // Protected version. Note that the het sample parameter is needed even
     // when heterogeneity is not used so don't try calling this without that.
     virtual double eval(double ageDays) const =0;
+    
+    /** Tabulate eval(double) for use by eval(SimTime, DecayFuncHet), which
+     * then interpolates linearly between table entries (for effective ages
+     * before the table end; others are evaluated directly).
+     * 
+     * The table extends to where the function falls below TABLE_TOLERANCE
+     * (or an effective age of 64). Its step is the largest (to a power of
+     * two) for which interpolation is within TABLE_TOLERANCE of the function
+     * at the quarter points of each step; if none is found the function is
+     * not tabulated. The error elsewhere is not checked, so this is only
+     * suitable for smooth functions. */
+    void tabulate();
+    
+private:
+    vector<double> table;
+    double tableEnd;    // effective age of last table entry (0 when not tabulated)
+    double invTableStep;
+    
+    friend class ::DecayFunctionSuite;
 };
 
 } }
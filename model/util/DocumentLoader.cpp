@@ -68,6 +68,58 @@ Checksum DocumentLoader::loadDocument (std::string lXmlFile){
     return cksum;
 }
 
+/** Erase the first element named name (including its contents) from text,
+ * if present. Elements of this name are assumed not to nest. */
+void eraseElement (string& text, const string& name){
+    const string open = "<" + name, close = "</" + name + ">";
+    size_t start = 0;
+    while( (start = text.find( open, start )) != string::npos ){
+        size_t next = start + open.size();
+        if( next < text.size() && string(" \t\r\n/>").find( text[next] ) != string::npos )
+            break;
+        start = next;   // e.g. <monitoringX: not the element we want
+    }
+    if( start == string::npos ) return;
+    size_t tagEnd = text.find( '>', start );
+    if( tagEnd == string::npos ) return;
+    size_t end;
+    if( text[tagEnd-1] == '/' ){
+        end = tagEnd + 1;       // empty element
+    }else{
+        end = text.find( close, tagEnd );
+        if( end == string::npos ) return;
+        end += close.size();
+    }
+    text.erase( start, end - start );
+}
+
+boost::uint64_t DocumentLoader::warmupChecksum() const{
+    return warmupChecksum( xmlFileName );
+}
+boost::uint64_t DocumentLoader::warmupChecksum( const string& fileName ){
+    ifstream fileStream (fileName.c_str(), ios::binary);
+    if (!fileStream.good())
+        throw util::xml_scenario_error ("Error: unable to open "+fileName);
+    ostringstream buf;
+    buf << fileStream.rdbuf();
+    string text = buf.str();
+    
+    // Skip the XML declaration and root tag (name, wuID, etc.)
+    size_t root = text.find( "scenario" );
+    if( root != string::npos )
+        root = text.find( '>', root );
+    text.erase( 0, root == string::npos ? 0 : root + 1 );
+    eraseElement( text, "monitoring" );
+    eraseElement( text, "interventions" );
+    
+    boost::uint64_t hash = 14695981039346656037ull;     // FNV-1a 64-bit
+    for( size_t i = 0; i < text.size(); ++i ){
+        hash ^= static_cast<unsigned char>( text[i] );
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
 void DocumentLoader::saveDocument()
 {
     if (documentChanged) {
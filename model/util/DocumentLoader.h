@@ -48,6 +48,18 @@ public:
     * Throws on failure. */
     util::Checksum loadDocument(std::string);
     
+    /** Checksum of the scenario document excluding the root element's tag
+     * and the <interventions> and <monitoring> elements: that is, of the
+     * parts which determine the simulation up to the start of the main
+     * phase. Used to check warm-up snapshots (see --save-warmup) match the
+     * scenario they are loaded into.
+     * 
+     * This is a plain FNV-1a hash of the text (so e.g. changing white-space
+     * elsewhere changes it), not a secure checksum. */
+    boost::uint64_t warmupChecksum() const;
+    /// As warmupChecksum(), for the scenario in file fileName.
+    static boost::uint64_t warmupChecksum( const std::string& fileName );
+    
     /** Save any changes which occurred to the document, if
         * documentChanged is true. */
     void saveDocument();
@@ -0,0 +1,221 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "util/batch.h"
+#include "util/CommandLine.h"
+#include "util/DocumentLoader.h"
+#include "util/errors.h"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <map>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+
+#if !defined(_WIN32) && defined(WITHOUT_BOINC)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace OM { namespace util { namespace batch {
+    using namespace std;
+    
+    vector<Entry> readManifest (const string& fileName) {
+        ifstream stream( fileName.c_str() );
+        if( !stream.good() )
+            throw cmd_exception( string("unable to read batch manifest ").append(fileName) );
+        vector<Entry> entries;
+        string line;
+        for( size_t lineNum = 1; getline( stream, line ); ++lineNum ){
+            istringstream words( line );
+            Entry entry;
+            if( !(words >> entry.name) || entry.name[0] == '#' )
+                continue;
+            if( !(words >> entry.scenario) )
+                (entry.scenario = "scenario").append(entry.name).append(".xml");
+            string extra;
+            if( words >> extra ){
+                ostringstream msg;
+                msg << fileName << ":" << lineNum << ": expected \"NAME [file.xml]\"";
+                throw cmd_exception( msg.str() );
+            }
+            entries.push_back( entry );
+        }
+        if( entries.empty() )
+            throw cmd_exception( string("no entries in batch manifest ").append(fileName) );
+        return entries;
+    }
+    
+#if !defined(_WIN32) && defined(WITHOUT_BOINC)
+    /** Entries whose scenarios have the same warm-up checksum (see
+     * DocumentLoader::warmupChecksum()); if more than one, they share a
+     * warm-up snapshot. */
+    struct Group {
+        enum State { PENDING, SAVING, READY, FAILED };
+        Group() : first(0), size(0), remaining(0), state(READY) {}
+        size_t first;           // index of first entry
+        size_t size;            // number of entries
+        size_t remaining;       // entries not yet finished
+        string snapshot;        // empty if not shared
+        State state;
+    };
+    /** A child process: runs entry index, or the warm-up of group index. */
+    struct Job {
+        Job() : index(0), warmup(false) {}
+        Job( size_t i, bool w ) : index(i), warmup(w) {}
+        size_t index;
+        bool warmup;
+    };
+    
+    /** Group entries by warm-up checksum. Entries whose scenario can't be
+     * read are left alone (the error is reported when the entry runs). */
+    void groupEntries( const vector<Entry>& entries, vector<size_t>& groupOf, vector<Group>& groups ){
+        map<boost::uint64_t,size_t> byChecksum;
+        for( size_t i = 0; i < entries.size(); ++i ){
+            size_t g = groups.size();
+            if( CommandLine::getLoadWarmupName().empty() ){
+                try{
+                    boost::uint64_t ck = DocumentLoader::warmupChecksum(
+                        CommandLine::lookupResource( entries[i].scenario ) );
+                    g = byChecksum.insert( make_pair( ck, g ) ).first->second;
+                }catch( const base_exception& ){}
+            }
+            if( g == groups.size() ){
+                groups.push_back( Group() );
+                groups.back().first = i;
+            }
+            groupOf[i] = g;
+            ++groups[g].size;
+        }
+        for( vector<Group>::iterator g = groups.begin(); g != groups.end(); ++g ){
+            g->remaining = g->size;
+            if( g->size > 1 ){
+                (g->snapshot = "warmup").append( entries[g->first].name ).append( ".snapshot" );
+                g->state = Group::PENDING;
+            }
+        }
+    }
+    
+    string forkEntries () {
+        const vector<Entry> entries = readManifest( CommandLine::getBatchName() );
+        const size_t jobs = CommandLine::getBatchJobs();
+        vector<size_t> groupOf( entries.size() );
+        vector<Group> groups;
+        groupEntries( entries, groupOf, groups );
+        vector<bool> started( entries.size(), false );
+        size_t nStarted = 0;
+        map<pid_t,Job> running;
+        int exitStatus = EXIT_SUCCESS;
+        
+        // Don't let children inherit (and print again) buffered output
+        cout << flush;
+        cerr << flush;
+        
+        while( nStarted < entries.size() || !running.empty() ){
+            // Start the first entry whose group's warm-up is done (or isn't
+            // shared), or else the first pending warm-up. There is always one
+            // unless some child is running.
+            if( running.size() < jobs ){
+                size_t next = entries.size();
+                for( size_t i = 0; i < entries.size(); ++i ){
+                    if( started[i] ) continue;
+                    const Group::State state = groups[groupOf[i]].state;
+                    if( state == Group::READY || state == Group::FAILED ){
+                        next = i;
+                        break;
+                    }else if( state == Group::PENDING && next == entries.size() ){
+                        next = i;
+                    }
+                }
+                if( next < entries.size() ){
+                    Group& group = groups[groupOf[next]];
+                    const bool warmup = group.state == Group::PENDING;
+                    pid_t pid = fork();
+                    if( pid < 0 ){
+                        throw base_exception( "batch: fork failed" );
+                    } else if( pid == 0 ){
+                        // child: run the warm-up of this entry's group, or the entry
+                        CommandLine::setBatchEntry( entries[next].name );
+                        if( !group.snapshot.empty() && group.state != Group::FAILED )
+                            CommandLine::setBatchWarmup( group.snapshot, warmup );
+                        return entries[next].scenario;
+                    }
+                    if( warmup ){
+                        group.state = Group::SAVING;
+                        running[pid] = Job( groupOf[next], true );
+                    }else{
+                        started[next] = true;
+                        ++nStarted;
+                        running[pid] = Job( next, false );
+                    }
+                    continue;
+                }
+            }
+            
+            int status;
+            pid_t pid = waitpid( -1, &status, 0 );
+            if( pid < 0 ){
+                if( errno == EINTR ) continue;
+                throw base_exception( "batch: waitpid failed" );
+            }
+            map<pid_t,Job>::iterator it = running.find( pid );
+            if( it == running.end() ) continue;
+            const Job job = it->second;
+            running.erase( it );
+            int code = WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
+            if( job.warmup ){
+                Group& group = groups[job.index];
+                if( code == EXIT_SUCCESS ){
+                    group.state = Group::READY;
+                }else{
+                    // run the entries without it; they report any error
+                    cerr << "Batch warm-up for " << entries[group.first].name
+                        << " failed with exit status " << code
+                        << "; simulating the warm-up per entry" << endl;
+                    group.state = Group::FAILED;
+                    std::remove( group.snapshot.c_str() );
+                }
+                continue;
+            }
+            const Entry& entry = entries[job.index];
+            if( code == EXIT_SUCCESS ){
+                cerr << "Batch entry " << entry.name << ": done" << endl;
+            }else{
+                cerr << "Batch entry " << entry.name << " (" << entry.scenario
+                    << "): failed with exit status " << code << endl;
+                if( exitStatus == EXIT_SUCCESS )
+                    exitStatus = code;
+            }
+            Group& group = groups[groupOf[job.index]];
+            if( --group.remaining == 0 && group.state == Group::READY && !group.snapshot.empty() )
+                std::remove( group.snapshot.c_str() );
+        }
+        
+        exit( exitStatus );
+    }
+#else
+    string forkEntries () {
+        throw cmd_exception( "--batch is not available on Windows or in BOINC builds" );
+    }
+#endif
+} } }
@@ -0,0 +1,69 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_util_batch
+#define Hmod_util_batch
+
+#include <string>
+#include <vector>
+
+namespace OM { namespace util {
+
+/** Batch mode (--batch): run several scenarios from one invocation.
+ *
+ * Each entry of the manifest is run by a child process forked from the
+ * batch process after command-line parsing. Simulations keep much of their
+ * state in static variables, so a child per entry is what allows entries to
+ * run concurrently (--batch-jobs) without sharing state.
+ * 
+ * The work shared is the warm-up: entries whose scenarios differ only in
+ * interventions and monitoring (see DocumentLoader::warmupChecksum()) are
+ * grouped, one child simulates the group's warm-up and saves a snapshot
+ * (as --save-warmup) then exits, and the group's entries start from it (as
+ * --load-warmup). Not done when --load-warmup is given.
+ * 
+ * Nothing else is shared: each child reads, validates and initialises its
+ * scenario from scratch, since the initialised state depends on the
+ * scenario and is held in static variables of many modules. */
+namespace batch {
+    /** One line of the manifest. */
+    struct Entry {
+        std::string name;       ///< as for --name
+        std::string scenario;   ///< scenario file (default scenarioNAME.xml)
+    };
+    
+    /** Read a manifest: one entry per line, "NAME [file.xml]". Blank lines
+     * and lines starting '#' are ignored.
+     * 
+     * Throws cmd_exception if the file can't be read or is malformed. */
+    std::vector<Entry> readManifest (const std::string& fileName);
+    
+    /** Run all entries of the manifest given by --batch, up to --batch-jobs
+     * at once (counting warm-up children).
+     * 
+     * In each child process, sets output names (and warm-up snapshot
+     * options) for its entry and returns the entry's scenario file, which
+     * the caller should then run as usual. In
+     * the batch process, waits for all children then exits with a non-zero
+     * status if any entry failed (so does not return). */
+    std::string forkEntries ();
+}
+} }
+#endif
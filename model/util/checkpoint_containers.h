@@ -26,6 +26,8 @@
 // otherwise "using ..." declaration in Global.h won't work
 #endif
 
+#include "util/errors.h"
+
 /** Provides some extra functions. See checkpoint.h. */
 namespace OM {
 namespace util {
@@ -62,6 +64,29 @@ namespace checkpoint {
         }
     }
     
+    /** Version of above which doesn't change the length of x when reading:
+     * stored elements beyond its length are discarded and other elements of
+     * x keep their values. For vectors whose length is determined by scenario
+     * elements which a warm-up snapshot may differ in (see Simulator). */
+    template<class T>
+    void checkpointKeepSize (vector<T>& x, istream& stream) {
+        size_t l;
+        l & stream;
+        validateListSize (l);
+        for( size_t i = 0; i < l; ++i ){
+            if( i < x.size() ){
+                x[i] & stream;
+            }else{
+                T discard;
+                discard & stream;
+            }
+        }
+    }
+    template<class T>
+    void checkpointKeepSize (vector<T>& x, ostream& stream) {
+        x & stream;
+    }
+    
     template<class T>
     void operator& (list<T> x, ostream& stream) {
         x.size() & stream;
@@ -124,5 +149,26 @@ namespace checkpoint {
     void operator& (multimap<double, double>& x, istream& stream);
     //@}
     
+    /** @brief Bulk arrays
+     * 
+     * Write or read all elements of a vector of plain data (e.g. numbers) as
+     * a single block. The length is not stored; the caller must do that. */
+    //@{
+    template<class T>
+    void writeArray (const vector<T>& x, ostream& stream) {
+        if( !x.empty() )
+            stream.write (reinterpret_cast<const char*>(&x[0]), x.size() * sizeof(T));
+    }
+    template<class T>
+    void readArray (vector<T>& x, size_t length, istream& stream) {
+        x.resize (length);
+        if( length == 0 ) return;
+        streamsize bytes = length * sizeof(T);
+        stream.read (reinterpret_cast<char*>(&x[0]), bytes);
+        if (!stream || stream.gcount() != bytes)
+            throw checkpoint_error ("stream read error array");
+    }
+    //@}
+    
 } } }   // end of namespaces
 #endif
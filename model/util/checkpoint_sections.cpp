@@ -0,0 +1,230 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "Global.h"
+#include "util/checkpoint_sections.h"
+#include "util/errors.h"
+
+#include <gzstream/gzstream.h>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define OM_CHECKPOINT_MMAP
+#endif
+
+namespace OM { namespace util { namespace checkpoint {
+
+// -----  SectionWriter  -----
+
+SectionWriter::CountingBuf::int_type SectionWriter::CountingBuf::overflow (int_type c) {
+    if( traits_type::eq_int_type (c, traits_type::eof()) )
+        return traits_type::not_eof (c);
+    if( traits_type::eq_int_type (m_dest->sputc (traits_type::to_char_type (c)), traits_type::eof()) )
+        return traits_type::eof();
+    ++m_count;
+    return c;
+}
+streamsize SectionWriter::CountingBuf::xsputn (const char* s, streamsize n) {
+    streamsize written = m_dest->sputn (s, n);
+    m_count += written;
+    return written;
+}
+int SectionWriter::CountingBuf::sync () {
+    return m_dest->pubsync ();
+}
+
+SectionWriter::SectionWriter (ostream& file) :
+    m_buf(file.rdbuf()), m_stream(&m_buf)
+{
+    header (m_stream);
+    FORMAT_VERSION & m_stream;
+}
+
+ostream& SectionWriter::begin (const string& name, uint32_t version) {
+    if( !table.empty() ) endSection ();
+    Entry entry;
+    entry.name = name;
+    entry.version = version;
+    entry.offset = m_buf.count();
+    entry.length = 0;
+    table.push_back (entry);
+    return m_stream;
+}
+
+void SectionWriter::endSection () {
+    table.back().length = m_buf.count() - table.back().offset;
+}
+
+void SectionWriter::finish () {
+    if( !table.empty() ) endSection ();
+    boost::uint64_t tableOffset = m_buf.count();
+    static_cast<uint32_t>(table.size()) & m_stream;
+    for( size_t i = 0; i < table.size(); ++i ){
+        table[i].name & m_stream;
+        table[i].version & m_stream;
+        table[i].offset & m_stream;
+        table[i].length & m_stream;
+    }
+    tableOffset & m_stream;
+    if( m_stream.fail() )
+        throw checkpoint_error ("stream write error");
+}
+
+
+// -----  FileData  -----
+
+FileData::FileData () : m_data(0), m_size(0), m_mapped(false) {}
+FileData::~FileData () {
+    unload ();
+}
+
+void FileData::unload () {
+#ifdef OM_CHECKPOINT_MMAP
+    if( m_mapped ) munmap (const_cast<char*>(m_data), m_size);
+#endif
+    m_data = 0;
+    m_size = 0;
+    m_mapped = false;
+    m_buffer.clear ();
+}
+
+bool FileData::load (const string& name, bool compressed) {
+    unload ();
+    if( compressed ){
+        igzstream in (name.c_str(), ios::in | ios::binary);
+        //Note: gzstreams are considered "good" when file not open!
+        if( !( in.good() && in.rdbuf()->is_open() ) )
+            return false;
+        const size_t BLOCK = 1 << 20;
+        while( in ){
+            size_t len = m_buffer.size();
+            m_buffer.resize (len + BLOCK);
+            in.read (&m_buffer[len], BLOCK);
+            m_buffer.resize (len + in.gcount());
+        }
+        if( !in.eof() )
+            throw checkpoint_error ("stream read error");
+    }else{
+#ifdef OM_CHECKPOINT_MMAP
+        int fd = open (name.c_str(), O_RDONLY);
+        if( fd < 0 ) return false;
+        struct stat st;
+        if( fstat (fd, &st) == 0 && st.st_size > 0 ){
+            void* p = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if( p != MAP_FAILED ){
+                m_data = static_cast<const char*>(p);
+                m_size = st.st_size;
+                m_mapped = true;
+            }
+        }
+        close (fd);
+        if( m_mapped ) return true;
+        // else fall back to reading (e.g. empty or unmappable files)
+#endif
+        ifstream in (name.c_str(), ios::in | ios::binary);
+        if( !in.good() ) return false;
+        in.seekg (0, ios::end);
+        m_buffer.resize (in.tellg());
+        in.seekg (0, ios::beg);
+        if( !m_buffer.empty() ) in.read (&m_buffer[0], m_buffer.size());
+        if( in.fail() )
+            throw checkpoint_error ("stream read error");
+    }
+    m_data = m_buffer.empty() ? 0 : &m_buffer[0];
+    m_size = m_buffer.size();
+    return true;
+}
+
+
+// -----  SectionReader  -----
+
+SectionReader::SectionReader (const char* data, size_t size) :
+    m_data(data), m_size(size), m_stream(&m_buf)
+{
+    m_buf.set (m_data, m_size);
+    header (m_stream);
+    uint32_t version;
+    version & m_stream;
+    if( version != FORMAT_VERSION ){
+        ostringstream msg;
+        msg << "checkpoint format version " << version << " is not supported (expected "
+            << FORMAT_VERSION << ")";
+        throw checkpoint_error (msg.str());
+    }
+    
+    boost::uint64_t tableOffset;
+    if( m_size < sizeof(tableOffset) )
+        throw checkpoint_error ("truncated checkpoint");
+    m_buf.set (m_data + m_size - sizeof(tableOffset), sizeof(tableOffset));
+    tableOffset & m_stream;
+    if( tableOffset > m_size - sizeof(tableOffset) )
+        throw checkpoint_error ("bad section table offset");
+    
+    m_buf.set (m_data + tableOffset, m_size - sizeof(tableOffset) - tableOffset);
+    uint32_t n;
+    n & m_stream;
+    validateListSize (n);
+    for( uint32_t i = 0; i < n; ++i ){
+        string name;
+        Entry entry;
+        name & m_stream;
+        entry.version & m_stream;
+        entry.offset & m_stream;
+        entry.length & m_stream;
+        if( entry.offset > tableOffset || entry.length > tableOffset - entry.offset )
+            throw checkpoint_error ("bad section table entry: " + name);
+        m_table[name] = entry;
+    }
+    if( m_buf.remaining() != 0 )
+        throw checkpoint_error ("bad section table");
+}
+
+istream& SectionReader::open (const string& name, uint32_t version) {
+    m_current = name;
+    map<string,Entry>::const_iterator it = m_table.find (name);
+    if( it == m_table.end() )
+        throw checkpoint_error ("missing section");
+    if( it->second.version != version ){
+        ostringstream msg;
+        msg << "section version " << it->second.version
+            << " is not supported (expected " << version << ")";
+        throw checkpoint_error (msg.str());
+    }
+    m_buf.set (m_data + it->second.offset, it->second.length);
+    m_stream.clear ();
+    return m_stream;
+}
+
+void SectionReader::close () {
+    if( m_stream.fail() )
+        throw checkpoint_error ("stream read error");
+    if( m_buf.remaining() != 0 ){
+        ostringstream msg;
+        msg << "section has " << m_buf.remaining() << " bytes remaining";
+        throw checkpoint_error (msg.str());
+    }
+}
+
+} } }
@@ -0,0 +1,172 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OM_util_checkpoint_sections
+#define OM_util_checkpoint_sections
+
+#ifndef Hmod_Global
+#error "Please include Global.h first."
+#endif
+
+#include <streambuf>
+
+/** Checkpoint file format, version 2.
+ *
+ * A checkpoint file consists of:
+ *  -   the header (see checkpoint::header()) and FORMAT_VERSION (uint32)
+ *  -   the data of each section, one after another
+ *  -   the section table: number of sections (uint32) then for each section
+ *      its name (string), version (uint32), offset and length (uint64)
+ *  -   the offset of the section table (uint64), as the last 8 bytes
+ *
+ * Offsets are in bytes from the start of the file. Each section holds the
+ * data of one subsystem, written with the usual operator& functions, and has
+ * its own version which should be incremented whenever that subsystem's
+ * checkpoint data changes. Sections are found via the table, so they are
+ * independent of each other, and are read directly from memory (the file is
+ * memory-mapped where possible; see FileData). */
+namespace OM { namespace util { namespace checkpoint {
+
+/// Version of the file format described above
+const uint32_t FORMAT_VERSION = 2;
+
+/** Writes a checkpoint file as a sequence of sections.
+ *
+ * Usage: call begin() for each section and write its data to the returned
+ * stream, then call finish(). Section data is written straight through to
+ * the file; offsets and lengths for the section table are taken from a
+ * count of the bytes written. */
+class SectionWriter {
+public:
+    /// Writes the header to file.
+    SectionWriter (ostream& file);
+    
+    /** End any previous section and begin a new one.
+     *
+     * @returns Stream to write the section's data to */
+    ostream& begin (const string& name, uint32_t version);
+    
+    /// End the last section and write the section table.
+    void finish ();
+    
+private:
+    void endSection ();
+    
+    // A stream buffer passing output on to another and counting bytes
+    // (tellp() is not supported by all streams, e.g. ogzstream)
+    class CountingBuf : public std::streambuf {
+    public:
+        CountingBuf (std::streambuf* dest) : m_dest(dest), m_count(0) {}
+        boost::uint64_t count () const{ return m_count; }
+    protected:
+        virtual int_type overflow (int_type c);
+        virtual streamsize xsputn (const char* s, streamsize n);
+        virtual int sync ();
+    private:
+        std::streambuf* m_dest;
+        boost::uint64_t m_count;
+    };
+    
+    struct Entry {
+        string name;
+        uint32_t version;
+        boost::uint64_t offset, length;
+    };
+    
+    CountingBuf m_buf;
+    ostream m_stream;           // writes to file via m_buf
+    vector<Entry> table;
+};
+
+/** Contents of a checkpoint file, in memory.
+ *
+ * Uncompressed files are memory-mapped where supported (otherwise read);
+ * gzip-compressed files are decompressed into a buffer. */
+class FileData {
+public:
+    FileData ();
+    ~FileData ();
+    
+    /** Load file name. Returns false if the file cannot be opened; throws
+     * checkpoint_error on read errors. */
+    bool load (const string& name, bool compressed);
+    
+    inline const char* data () const{ return m_data; }
+    inline size_t size () const{ return m_size; }
+    
+private:
+    FileData (const FileData&);        // not copyable
+    void unload ();
+    
+    const char* m_data;
+    size_t m_size;
+    bool m_mapped;              // true if m_data is mapped memory
+    vector<char> m_buffer;      // holds data when not mapped
+};
+
+/** Reads sections from a checkpoint in memory. */
+class SectionReader {
+public:
+    /** Check the header and read the section table of data (which must
+     * remain valid while this object is used).
+     *
+     * Throws checkpoint_error if the data is not a checkpoint of this format. */
+    SectionReader (const char* data, size_t size);
+    
+    /** Open a section and return a stream over its data (valid until the
+     * next call to open()). Data is read in place, without copying.
+     *
+     * Throws checkpoint_error if there is no such section or it has
+     * another version. */
+    istream& open (const string& name, uint32_t version);
+    
+    /** Throw checkpoint_error unless the last section opened was read
+     * exactly to its end. */
+    void close ();
+    
+    /// Name of the last section opened (for error messages)
+    inline const string& current () const{ return m_current; }
+    
+private:
+    // A read-only stream buffer over memory
+    class MemoryBuf : public std::streambuf {
+    public:
+        void set (const char* begin, size_t length){
+            char* b = const_cast<char*>(begin);  // not written to
+            setg (b, b, b + length);
+        }
+        streamsize remaining () const{ return egptr() - gptr(); }
+    };
+    
+    struct Entry {
+        uint32_t version;
+        boost::uint64_t offset, length;
+    };
+    
+    const char* m_data;
+    size_t m_size;
+    map<string,Entry> m_table;
+    string m_current;
+    MemoryBuf m_buf;
+    istream m_stream;
+};
+
+} } }
+#endif
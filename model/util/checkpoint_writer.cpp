@@ -0,0 +1,206 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "util/checkpoint_writer.h"
+#include "util/errors.h"
+
+#include <gzstream/gzstream.h>
+#include <fstream>
+#include <cstdio>       // rename, remove
+#include <cassert>
+
+using namespace std;
+
+namespace OM { namespace util { namespace checkpoint {
+
+void writePointerFile (const string& name, int checkpointNum) {
+    string tmpName = name + ".tmp";
+    {
+        ofstream file (tmpName.c_str(), ios::out);
+        file << checkpointNum;
+        file.close();
+        if (!file)
+            throw checkpoint_error ("error writing to file \"" + tmpName + "\"");
+    }
+#ifdef _WIN32
+    bool renamed = MoveFileExA (tmpName.c_str(), name.c_str(),
+                                MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    bool renamed = rename (tmpName.c_str(), name.c_str()) == 0;
+#endif
+    if (!renamed)
+        throw checkpoint_error ("error writing to file \"" + name + "\"");
+}
+
+StringBuf::int_type StringBuf::overflow (int_type c) {
+    if (!traits_type::eq_int_type (c, traits_type::eof()))
+        m_data.push_back (traits_type::to_char_type (c));
+    return traits_type::not_eof (c);
+}
+streamsize StringBuf::xsputn (const char* s, streamsize n) {
+    m_data.append (s, n);
+    return n;
+}
+
+namespace background {
+
+/// Everything the background thread needs; owned by this module.
+struct Job {
+    string data;
+    string fileName, pointerName, truncateName;
+    bool compress;
+    int checkpointNum;
+    
+    // Set by the background thread:
+    string error;       // empty on success
+};
+
+Job job;
+bool isPending = false;
+
+template<class S>
+void writeData (const string& data, const string& fileName) {
+    S out (fileName.c_str(), ios::out | ios::binary);
+    out.write (data.data(), data.size());
+    out.close ();
+    if (out.fail())
+        throw checkpoint_error ("error writing to file \"" + fileName + "\"");
+}
+
+void runJob () {
+    try {
+        if (job.compress)
+            writeData<ogzstream> (job.data, job.fileName);
+        else
+            writeData<ofstream> (job.data, job.fileName);
+        // free memory early; nothing else reads it
+        string().swap (job.data);
+        
+        writePointerFile (job.pointerName, job.checkpointNum);
+        
+        // Truncate the old checkpoint to save disk space
+        if (!job.truncateName.empty()) {
+            ofstream out (job.truncateName.c_str(), ios::out | ios::binary);
+            out.close ();
+        }
+    } catch (const exception& e) {
+        job.error = e.what();
+    }
+}
+
+#ifdef _WIN32
+HANDLE thread;
+
+DWORD WINAPI threadMain (PVOID) {
+    runJob ();
+    return 0;
+}
+
+bool startThread () {
+    thread = CreateThread (NULL, 0, threadMain, NULL, 0, NULL);
+    return thread != NULL;
+}
+bool threadDone () {
+    return WaitForSingleObject (thread, 0) == WAIT_OBJECT_0;
+}
+bool joinThread () {
+    bool ok = WaitForSingleObject (thread, INFINITE) == WAIT_OBJECT_0;
+    CloseHandle (thread);
+    return ok;
+}
+
+#else
+
+pthread_t thread;
+pthread_mutex_t doneMutex = PTHREAD_MUTEX_INITIALIZER;
+bool done = false;
+
+void* threadMain (void*) {
+    runJob ();
+    pthread_mutex_lock (&doneMutex);
+    done = true;
+    pthread_mutex_unlock (&doneMutex);
+    return 0;
+}
+
+bool startThread () {
+    done = false;
+    return pthread_create (&thread, NULL, threadMain, NULL) == 0;
+}
+bool threadDone () {
+    pthread_mutex_lock (&doneMutex);
+    bool result = done;
+    pthread_mutex_unlock (&doneMutex);
+    return result;
+}
+bool joinThread () {
+    return pthread_join (thread, NULL) == 0;
+}
+#endif
+
+void start (string& data, const string& fileName, bool compress,
+            const string& pointerName, int checkpointNum,
+            const string& truncateName)
+{
+    assert (!isPending);
+    job.data.swap (data);
+    data.clear ();
+    job.fileName = fileName;
+    job.compress = compress;
+    job.pointerName = pointerName;
+    job.checkpointNum = checkpointNum;
+    job.truncateName = truncateName;
+    job.error.clear ();
+    
+    if (!startThread ()) {
+        // Fall back to writing in this thread
+        runJob ();
+        if (!job.error.empty())
+            throw checkpoint_error (job.error);
+        return;
+    }
+    isPending = true;
+}
+
+bool pending () {
+    return isPending;
+}
+
+bool completed () {
+    return isPending && threadDone ();
+}
+
+void finish () {
+    if (!isPending) return;
+    isPending = false;
+    if (!joinThread ())
+        throw checkpoint_error ("unable to join checkpoint writing thread");
+    if (!job.error.empty())
+        throw checkpoint_error (job.error);
+}
+
+}
+} } }
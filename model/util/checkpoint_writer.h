@@ -0,0 +1,87 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OM_util_checkpoint_writer
+#define OM_util_checkpoint_writer
+
+#include <string>
+#include <streambuf>
+
+/** Writing of checkpoint files to disk, optionally in a background thread.
+ *
+ * The simulation state is first serialised to memory (see Simulator), which
+ * is fast compared to compressing and writing it. A background writer then
+ * writes the data while the simulation continues. The pointer file (which
+ * names the latest checkpoint) is only replaced once the data has been
+ * written, and is replaced atomically, so an interrupted write always leaves
+ * the previous checkpoint usable. */
+namespace OM { namespace util { namespace checkpoint {
+
+/** Write checkpointNum to the pointer file called name.
+ *
+ * The value is written to a temporary file which is then renamed over name,
+ * so readers see either the old or the new value, never a partial file.
+ * Throws checkpoint_error on failure. */
+void writePointerFile (const std::string& name, int checkpointNum);
+
+/** A stream buffer appending output to a string owned by the caller.
+ * 
+ * Unlike with an ostringstream, the data can then be swapped out of the
+ * string without a copy (see background::start()). */
+class StringBuf : public std::streambuf {
+public:
+    StringBuf (std::string& data) : m_data(data) {}
+protected:
+    virtual int_type overflow (int_type c);
+    virtual std::streamsize xsputn (const char* s, std::streamsize n);
+private:
+    std::string& m_data;
+};
+
+/** Writes one checkpoint at a time in a background thread.
+ *
+ * Only one write may be pending: finish() must be called before the next
+ * start(). */
+namespace background {
+    /** Start writing a checkpoint in a background thread.
+     * 
+     * The thread writes data to fileName (gzip compressed if compress is
+     * true), then updates pointerName to checkpointNum with
+     * writePointerFile(), then truncates truncateName (unless empty).
+     * 
+     * data is swapped out to avoid a copy; it is left empty. */
+    void start (std::string& data, const std::string& fileName, bool compress,
+                const std::string& pointerName, int checkpointNum,
+                const std::string& truncateName);
+    
+    /// True when a write was started and finish() has not been called since.
+    bool pending ();
+    
+    /// True when the pending write has completed. Does not block.
+    bool completed ();
+    
+    /** Wait for the pending write to complete, if there is one.
+     * 
+     * Throws checkpoint_error if the write failed. */
+    void finish ();
+}
+
+} } }
+#endif
@@ -0,0 +1,69 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "util/parallel.h"
+#include "util/errors.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OM { namespace util {
+
+/// Number of threads (see parallel::numThreads())
+static size_t nThreads = 1;
+
+void parallel::init( size_t n ){
+    if( n == 0 ){
+        throw cmd_exception( "number of threads must be at least 1" );
+    }
+#ifdef _OPENMP
+    nThreads = n;
+    omp_set_num_threads( static_cast<int>(n) );
+    omp_set_dynamic( 0 );       // partitioning must not depend on load
+    // nested regions (e.g. genotypes within species) use the calling thread
+    // only, whatever OMP_NESTED and OMP_MAX_ACTIVE_LEVELS say
+    omp_set_max_active_levels( 1 );
+#   ifdef OM_STREAM_VALIDATOR
+    if( n > 1 ){
+        throw cmd_exception( "--threads: not compatible with OM_STREAM_VALIDATOR" );
+    }
+#   endif
+#else
+    if( n > 1 ){
+        throw cmd_exception( "--threads: OpenMalaria was compiled without "
+            "threading support (enable OM_OPENMP)" );
+    }
+#endif
+}
+
+size_t parallel::numThreads(){
+    return nThreads;
+}
+
+size_t parallel::threadIndex(){
+#ifdef _OPENMP
+    return static_cast<size_t>( omp_get_thread_num() );
+#else
+    return 0;
+#endif
+}
+
+} }
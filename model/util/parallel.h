@@ -0,0 +1,58 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_util_parallel
+#define Hmod_util_parallel
+
+#include "Global.h"
+
+namespace OM { namespace util {
+
+/** Support for updating the human population (and mosquito species, see
+ * VectorModel::advanceSpecies()) using multiple threads.
+ * 
+ * Threading is only available when compiled with OpenMP (CMake option
+ * OM_OPENMP) and requested with the --threads command-line option. Otherwise
+ * all functions here behave as if there was a single thread and the
+ * simulation is identical to that of a build without threading support.
+ * 
+ * Only one level of parallel regions is active: a parallel region entered
+ * from within another runs on the calling thread alone.
+ * 
+ * Code run inside a parallel region must use per-thread state (indexed by
+ * threadIndex()) for anything shared, merged after the region. */
+namespace parallel {
+    /** Set the number of threads used for the human update. Must be called
+     * before other modules are initialised (random number generators and
+     * monitoring stores allocate per-thread data during initialisation).
+     * 
+     * Throws cmd_exception if n > 1 and threading was not compiled in. */
+    void init( size_t n );
+    
+    /// Number of threads used by parallel regions (1 when not threaded).
+    size_t numThreads();
+    
+    /** Index of the calling thread within the current parallel region, in
+     * the range [0, numThreads()). Returns 0 outside parallel regions. */
+    size_t threadIndex();
+}
+
+} }
+#endif
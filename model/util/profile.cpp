@@ -0,0 +1,92 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "util/profile.h"
+
+#ifdef OM_PROFILE
+#include "util/errors.h"
+#include <fstream>
+#include <vector>
+
+namespace OM { namespace util {
+
+namespace profile {
+    const char* timerNames[NUM_TIMERS] = {
+        "POP_UPDATE", "VECTOR_UPDATE", "WITHIN_HOST_UPDATE", "PKPD",
+        "CLINICAL_UPDATE", "INTERVENTIONS", "CONTINUOUS", "SURVEYS"
+    };
+    const char* counterNames[NUM_COUNTERS] = {
+        "INFECTIONS_CREATED", "INFECTIONS_CLEARED", "DRUG_DOSES", "RNG_DRAWS"
+    };
+    
+    /// Data for one thread. Padded so that threads don't share cache lines.
+    struct ThreadData {
+        ThreadData() {
+            for( size_t i = 0; i < NUM_TIMERS; ++i ){ seconds[i] = 0.0; calls[i] = 0; }
+            for( size_t i = 0; i < NUM_COUNTERS; ++i ){ counts[i] = 0; }
+        }
+        double seconds[NUM_TIMERS];
+        boost::int64_t calls[NUM_TIMERS];
+        boost::int64_t counts[NUM_COUNTERS];
+        char padding[64];
+    };
+    std::vector<ThreadData> threadData( 1 );
+}
+
+void profile::init(){
+    threadData.assign( parallel::numThreads(), ThreadData() );
+}
+
+void profile::addTime( Timer timer, double seconds ){
+    ThreadData& data = threadData[parallel::threadIndex()];
+    data.seconds[timer] += seconds;
+    data.calls[timer] += 1;
+}
+
+void profile::addCount( Counter counter, boost::int64_t n ){
+    threadData[parallel::threadIndex()].counts[counter] += n;
+}
+
+void profile::write( const std::string& fileName ){
+    std::ofstream file( fileName.c_str() );
+    for( size_t i = 0; i < NUM_TIMERS; ++i ){
+        double seconds = 0.0;
+        boost::int64_t calls = 0;
+        for( size_t t = 0; t < threadData.size(); ++t ){
+            seconds += threadData[t].seconds[i];
+            calls += threadData[t].calls[i];
+        }
+        file << "timer\t" << timerNames[i] << '\t' << seconds << '\t' << calls << '\n';
+    }
+    for( size_t i = 0; i < NUM_COUNTERS; ++i ){
+        boost::int64_t n = 0;
+        for( size_t t = 0; t < threadData.size(); ++t ){
+            n += threadData[t].counts[i];
+        }
+        file << "counter\t" << counterNames[i] << '\t' << n << '\n';
+    }
+    file.flush();
+    if( !file ){
+        throw base_exception( std::string("unable to write ").append(fileName) );
+    }
+}
+
+} }
+#endif
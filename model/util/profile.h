@@ -0,0 +1,111 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_util_profile
+#define Hmod_util_profile
+
+#include <boost/cstdint.hpp>
+#include <string>
+
+// Compile-time optional
+#ifdef OM_PROFILE
+#include "util/parallel.h"
+#include "util/timer.h"
+#endif
+
+namespace OM { namespace util {
+
+/** @brief Hot-path profiling: scoped timers and event counters.
+ * 
+ * Enable with the CMake option OM_PROFILE. When disabled, all functions here
+ * are empty and inline, so they should be optimised out.
+ * 
+ * When enabled, timers accumulate wall-clock time and the number of calls
+ * per timed section; counters count events. Both are kept per thread (see
+ * util::parallel) and summed on output. Timed sections may be nested; each
+ * timer records inclusive time. At the end of the run, the simulator writes
+ * the profile to profile.txt, or profileNAME.txt with --name NAME or batch
+ * entry NAME, in the working directory (see write()).
+ * 
+ * Usage: place "util::profile::Scope scope( util::profile::POP_UPDATE );" at
+ * the start of a block to time it, and
+ * "util::profile::count( util::profile::DRUG_DOSES );" where an event happens.
+ */
+namespace profile {
+    /// Timed sections
+    enum Timer {
+        POP_UPDATE,         ///< Population::update1
+        VECTOR_UPDATE,      ///< VectorModel::vectorUpdate
+        WITHIN_HOST_UPDATE, ///< CommonWithinHost::update
+        PKPD,               ///< LSTMModel::medicate and decayDrugs
+        CLINICAL_UPDATE,    ///< ClinicalModel::update
+        INTERVENTIONS,      ///< InterventionManager::deploy
+        CONTINUOUS,         ///< Continuous.update
+        SURVEYS,            ///< Surveys and writing survey output
+        NUM_TIMERS
+    };
+    /// Counted events
+    enum Counter {
+        INFECTIONS_CREATED,     ///< New and imported infections
+        INFECTIONS_CLEARED,     ///< Infections terminated or cleared by treatment
+        DRUG_DOSES,             ///< Doses given by the PK/PD model
+        RNG_DRAWS,              ///< Random variates sampled (util::random)
+        NUM_COUNTERS
+    };
+    
+#ifdef OM_PROFILE
+    /** Allocate per-thread storage. Call after util::parallel::init(). */
+    void init();
+    
+    void addTime( Timer timer, double seconds );
+    void addCount( Counter counter, boost::int64_t n );
+    
+    /** Write the profile to the named file: one line per timer
+     * ("timer<tab>name<tab>seconds<tab>calls") then one per counter
+     * ("counter<tab>name<tab>count"). Measurements are only of the part of
+     * the run done by this process. */
+    void write( const std::string& fileName );
+    
+    /// Times its own lifetime against a Timer
+    class Scope {
+    public:
+        explicit Scope( Timer timer ) : m_timer(timer), m_start(timer::wallTime()) {}
+        ~Scope(){ addTime( m_timer, timer::wallTime() - m_start ); }
+    private:
+        Timer m_timer;
+        double m_start;
+    };
+    
+    inline void count( Counter counter, boost::int64_t n = 1 ){
+        addCount( counter, n );
+    }
+#else
+    inline void init() {}
+    inline void write( const std::string& ) {}
+    class Scope {
+    public:
+        explicit Scope( Timer ) {}
+    };
+    inline void count( Counter, boost::int64_t = 1 ) {}
+#endif
+}
+
+} }
+#endif
@@ -20,8 +20,9 @@
 
 /* This module contains the random-number generator and distributions wrapper.
  *
- * Currently both the GSL and boost generators are implemented. The
- * distributions all come from the GSL library so far.
+ * Currently both the GSL and boost generators are implemented, as well as a
+ * counter-based generator (Philox4x32-10) wrapped as a GSL generator type.
+ * The distributions all come from the GSL library so far.
  * 
  * Using the boost generator appears (in rough tests) to be slightly
  * slower, which is understandable since the GSL distributions must then use a
@@ -38,6 +39,8 @@
 #include "util/random.h"
 #include "util/errors.h"
 #include "util/StreamValidator.h"
+#include "util/parallel.h"
+#include "util/profile.h"
 #include "Global.h"
 
 #ifdef OM_RANDOM_USE_BOOST
@@ -85,12 +88,109 @@ namespace OM { namespace util {
     };
 # endif
 
+// -----  counter-based generator  -----
+
+/* State of the counter-based generator. Output is computed a block (four
+ * words) at a time from key and ctr; ctr[0] and ctr[1] form a block counter
+ * while ctr[2] and ctr[3] hold the stream's purpose and time step.
+ * 
+ * key[1] holds the thread index (when ctr[2] is 0) or the human's identifier
+ * (for streams selected by beginStream(), where ctr[2] is non-zero). */
+struct CounterState {
+    uint32_t key[2];
+    uint32_t ctr[4];
+    uint32_t out[4];
+    uint32_t pos;       // next word of out to return; 4 if all used
+    
+    template<class S>
+    void operator& (S& stream) {
+        for( size_t i = 0; i < 2; ++i ) key[i] & stream;
+        for( size_t i = 0; i < 4; ++i ) ctr[i] & stream;
+        for( size_t i = 0; i < 4; ++i ) out[i] & stream;
+        pos & stream;
+    }
+};
+
+inline void mulhilo32 (uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo) {
+    boost::uint64_t p = static_cast<boost::uint64_t>(a) * b;
+    hi = static_cast<uint32_t>(p >> 32);
+    lo = static_cast<uint32_t>(p);
+}
+
+/* Philox4x32 with 10 rounds, as described by Salmon et al., "Parallel random
+ * numbers: as easy as 1, 2, 3" (SC'11). */
+void philox4x32_10 (const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4]) {
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for( int round = 0; round < 10; ++round ){
+	if( round > 0 ){
+	    k0 += 0x9E3779B9u;
+	    k1 += 0xBB67AE85u;
+	}
+	uint32_t hi0, lo0, hi1, lo1;
+	mulhilo32 (0xD2511F53u, c0, hi0, lo0);
+	mulhilo32 (0xCD9E8D57u, c2, hi1, lo1);
+	c0 = hi1 ^ c1 ^ k0;
+	c1 = lo1;
+	c2 = hi0 ^ c3 ^ k1;
+	c3 = lo0;
+    }
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+unsigned long counter_rng_get (void* vstate) {
+    CounterState& s = *static_cast<CounterState*>(vstate);
+    if( s.pos >= 4 ){
+	philox4x32_10 (s.ctr, s.key, s.out);
+	s.ctr[0] += 1;
+	if( s.ctr[0] == 0 ) s.ctr[1] += 1;
+	s.pos = 0;
+    }
+    return s.out[s.pos++];
+}
+double counter_rng_get_double (void* vstate) {
+    return counter_rng_get (vstate) / 4294967296.0;	// in [0,1)
+}
+void counter_rng_set (void* vstate, unsigned long seed) {
+    CounterState& s = *static_cast<CounterState*>(vstate);
+    s.key[0] = static_cast<uint32_t>(seed);
+    s.key[1] = 0;
+    for( size_t i = 0; i < 4; ++i ) s.ctr[i] = 0;
+    s.pos = 4;
+}
+
+static const gsl_rng_type counter_type = {
+    "philox4x32_10",		// name
+    0xFFFFFFFFUL,		// max value
+    0,				// min value
+    sizeof(CounterState),	// size of state
+    &counter_rng_set,
+    &counter_rng_get,
+    &counter_rng_get_double
+};
+
+inline CounterState& counterState (gsl_rng* gen) {
+    assert( gen->type == &counter_type );
+    return *static_cast<CounterState*>(gen->state);
+}
+
+
 // This should be created and deleted automatically, taking care of
 // allocating and freeing the generator.
 struct generator_factory {
     gsl_rng * gsl_generator;
+    // Generators used by threads 1, 2, ... when updating humans in parallel
+    // (thread 0 uses gsl_generator). Empty when not threaded.
+    vector<gsl_rng*> thread_generators;
+    
+    // True when using counter_type generators (see useCounterGenerator()).
+    bool use_counter;
+    // Counter-based only: generator used for streams selected by
+    // beginStream() for each thread, and whether such a stream is selected.
+    vector<gsl_rng*> stream_generators;
+    vector<char> in_stream;
     
-    generator_factory () {
+    generator_factory () : use_counter (false) {
 #	ifdef OM_RANDOM_USE_BOOST
 	// In this case, I construct a wrapper around boost's generator. The reason for this is
 	// that it allows use of distributions from both boost and GSL.
@@ -108,22 +208,122 @@ struct generator_factory {
 #	else
 	gsl_rng_free (gsl_generator);
 #	endif
+	freeThreadGenerators ();
+    }
+    void freeThreadGenerators () {
+	for( size_t i = 0; i < thread_generators.size(); ++i )
+	    gsl_rng_free (thread_generators[i]);
+	thread_generators.clear ();
+	for( size_t i = 0; i < stream_generators.size(); ++i )
+	    gsl_rng_free (stream_generators[i]);
+	stream_generators.clear ();
+	in_stream.clear ();
     }
 } rng;
 
+/* Generator for the calling thread. */
+inline gsl_rng* generator () {
+    profile::count( profile::RNG_DRAWS );     // (almost) one call per variate
+    size_t t = parallel::threadIndex ();
+    if( !rng.in_stream.empty() && rng.in_stream[t] ) return rng.stream_generators[t];
+    if( t == 0 ) return rng.gsl_generator;
+    assert( t <= rng.thread_generators.size() );
+    return rng.thread_generators[t-1];
+}
+
 // -----  set-up, tear-down and checkpointing  -----
 
+void random::useCounterGenerator () {
+# ifdef OM_RANDOM_USE_BOOST
+    throw util::cmd_exception( "--counter-rng: not supported when compiled "
+	"with OM_RANDOM_USE_BOOST" );
+# else
+    gsl_rng_free (rng.gsl_generator);
+    rng.gsl_generator = gsl_rng_alloc(&counter_type);
+    rng.use_counter = true;
+# endif
+}
+
 void random::seed (uint32_t seed) {
 //     util::streamValidate(seed);
 # ifdef OM_RANDOM_USE_BOOST
     if (seed == 0) seed = 4357;	// gsl compatibility − ugh
     boost_generator.seed (seed);
+    if( parallel::numThreads() > 1 ){
+	throw util::cmd_exception( "--threads: not supported when compiled "
+	    "with OM_RANDOM_USE_BOOST" );
+    }
 # else
     gsl_rng_set (rng.gsl_generator, seed);
+    rng.freeThreadGenerators ();
+    
+    if( rng.use_counter ){
+	// All generators share the key's seed; the threads' usual streams
+	// are distinguished by thread index.
+	for( size_t t = 0; t < parallel::numThreads(); ++t ){
+	    if( t > 0 ){
+		gsl_rng *gen = gsl_rng_alloc(&counter_type);
+		gsl_rng_set (gen, seed);
+		counterState(gen).key[1] = t;
+		rng.thread_generators.push_back (gen);
+	    }
+	    gsl_rng *gen = gsl_rng_alloc(&counter_type);
+	    gsl_rng_set (gen, seed);
+	    rng.stream_generators.push_back (gen);
+	}
+	rng.in_stream.assign (parallel::numThreads(), false);
+	return;
+    }
+    
+    // Each additional thread gets its own stream. Seeds are derived from the
+    // scenario's seed so that results are reproducible for a given number of
+    // threads; the first thread's stream is unchanged.
+    for( size_t t = 1; t < parallel::numThreads(); ++t ){
+	gsl_rng *gen = gsl_rng_alloc(gsl_rng_mt19937);
+	gsl_rng_set (gen, seed ^ static_cast<uint32_t>(0x9E3779B9u * t));
+	rng.thread_generators.push_back (gen);
+    }
 # endif
 }
 
+# ifndef OM_RANDOM_USE_BOOST
+// Write or read the state of a GSL generator in a checkpoint stream. Don't
+// use OM::util::checkpoint functions for the data; validateListSize uses too
+// small a number.
+void writeGslState (const gsl_rng* gen, ostream& stream) {
+    size_t len = gsl_rng_size (gen);
+    len & stream;
+    stream.write (static_cast<const char*>(gsl_rng_state (gen)), len);
+}
+void readGslState (gsl_rng* gen, istream& stream) {
+    size_t len;
+    len & stream;
+    if (len != gsl_rng_size (gen))
+	throw checkpoint_error ("random: bad generator state");
+    stream.read (static_cast<char*>(gsl_rng_state (gen)), len);
+    if (!stream || stream.gcount() != streamsize(len))
+	throw checkpoint_error ("stream read error random");
+}
+# endif
+
 void random::checkpoint (istream& stream, int seedFileNumber) {
+    bool counter;
+    counter & stream;
+    if( counter != rng.use_counter )
+	throw checkpoint_error ("checkpoint was written using a different random "
+	    "number generator (see --counter-rng)");
+    if( rng.use_counter ){
+	// Only the first thread's usual stream is used outside of
+	// beginStream()/endStream() when its state matters, so other threads'
+	// states are not stored (and checkpoints don't depend on --threads).
+	CounterState& state = counterState (rng.gsl_generator);
+	uint32_t seed = state.key[0];
+	state & stream;
+	if( state.key[0] != seed || state.key[1] != 0 || state.pos > 4 )
+	    throw checkpoint_error ("random: bad generator state");
+	return;
+    }
+    
 # ifdef OM_RANDOM_USE_BOOST
     // Don't use OM::util::checkpoint function for loading a stream; checkpoint::validateListSize uses too small a number.
     string str;
@@ -137,6 +337,17 @@ void random::checkpoint (istream& stream, int seedFileNumber) {
     ss >> boost_generator;
 # else
     
+    if( seedFileNumber < 0 ){
+	size_t nThreads;
+	nThreads & stream;
+	if( nThreads != rng.thread_generators.size() )
+	    throw checkpoint_error ("random: state was written using a different number of threads");
+	readGslState (rng.gsl_generator, stream);
+	for( size_t i = 0; i < rng.thread_generators.size(); ++i )
+	    readGslState (rng.thread_generators[i], stream);
+	return;
+    }
+    
     ostringstream seedN;
     seedN << string("seed") << seedFileNumber;
     FILE * f = fopen(seedN.str().c_str(), "rb");
@@ -144,26 +355,68 @@ void random::checkpoint (istream& stream, int seedFileNumber) {
 	throw checkpoint_error (string("load_rng_state: file not found: ").append(seedN.str()));
     if (gsl_rng_fread(f, rng.gsl_generator) != 0)
 	throw checkpoint_error ("gsl_rng_fread failed");
+    for( size_t i = 0; i < rng.thread_generators.size(); ++i ){
+	if (gsl_rng_fread(f, rng.thread_generators[i]) != 0)
+	    throw checkpoint_error ("gsl_rng_fread failed (was the "
+		"checkpoint written using the same number of threads?)");
+    }
     fclose (f);
 # endif
 }
 
 void random::checkpoint (ostream& stream, int seedFileNumber) {
+    rng.use_counter & stream;
+    if( rng.use_counter ){
+	counterState (rng.gsl_generator) & stream;
+	return;
+    }
+    
 # ifdef OM_RANDOM_USE_BOOST
     ostringstream ss;
     ss << boost_generator;
     ss.str() & stream;
 # else
     
+    if( seedFileNumber < 0 ){
+	rng.thread_generators.size() & stream;
+	writeGslState (rng.gsl_generator, stream);
+	for( size_t i = 0; i < rng.thread_generators.size(); ++i )
+	    writeGslState (rng.thread_generators[i], stream);
+	return;
+    }
+    
     ostringstream seedN;
     seedN << string("seed") << seedFileNumber;
     FILE * f = fopen(seedN.str().c_str(), "wb");
     if (gsl_rng_fwrite(f, rng.gsl_generator) != 0)
 	throw checkpoint_error ("gsl_rng_fwrite failed");
+    for( size_t i = 0; i < rng.thread_generators.size(); ++i ){
+	if (gsl_rng_fwrite(f, rng.thread_generators[i]) != 0)
+	    throw checkpoint_error ("gsl_rng_fwrite failed");
+    }
     fclose (f);
 # endif
 }
 
+void random::beginStream (uint32_t id, StreamPurpose purpose, SimTime time) {
+    if( !rng.use_counter ) return;
+    size_t t = parallel::threadIndex ();
+    assert( !rng.in_stream[t] );	// streams may not be nested
+    CounterState& state = counterState (rng.stream_generators[t]);
+    state.key[1] = id;
+    state.ctr[0] = 0;
+    state.ctr[1] = 0;
+    state.ctr[2] = purpose;
+    state.ctr[3] = static_cast<uint32_t>(time.inSteps());
+    state.pos = 4;
+    rng.in_stream[t] = true;
+}
+
+void random::endStream () {
+    if( !rng.use_counter ) return;
+    rng.in_stream[parallel::threadIndex ()] = false;
+}
+
 
 // -----  random number generation  -----
 
@@ -173,36 +426,76 @@ double random::uniform_01 () {
 # ifdef OM_RANDOM_USE_BOOST
         rng_uniform01 ();
 # else
-        gsl_rng_uniform (rng.gsl_generator);
+        gsl_rng_uniform (generator());
 # endif
 //     util::streamValidate(result);
     return result;
 }
 
+void random::uniform_01 (double* out, size_t n) {
+# ifdef OM_RANDOM_USE_BOOST
+    for( size_t i = 0; i < n; ++i )
+	out[i] = rng_uniform01 ();
+# else
+    gsl_rng *gen = generator();
+    if( n > 1 ) profile::count( profile::RNG_DRAWS, n - 1 );
+    if( gen->type == &counter_type ){
+	// direct (inlinable) calls: no indirection through the GSL type
+	for( size_t i = 0; i < n; ++i )
+	    out[i] = counter_rng_get_double (gen->state);
+    }else{
+	for( size_t i = 0; i < n; ++i )
+	    out[i] = gsl_rng_uniform (gen);
+    }
+# endif
+}
+
 double random::gauss (double mean, double std){
-    double result = gsl_ran_gaussian(rng.gsl_generator,std)+mean;
+    double result = gsl_ran_gaussian(generator(),std)+mean;
 //     util::streamValidate(result);
     return result;
 }
 double random::gauss (double std){
-    double result = gsl_ran_gaussian(rng.gsl_generator,std);
+    double result = gsl_ran_gaussian(generator(),std);
 //     util::streamValidate(result);
     return result;
 }
 
+void random::gauss (double mean, double std, double* out, size_t n){
+    gsl_rng *gen = generator();
+    for( size_t i = 0; i < n; ++i )
+	out[i] = gsl_ran_gaussian(gen,std)+mean;
+}
+void random::gauss (const double* mean, const double* std, double* out, size_t n){
+    gsl_rng *gen = generator();
+    for( size_t i = 0; i < n; ++i )
+	out[i] = gsl_ran_gaussian(gen,std[i])+mean[i];
+}
+
 double random::gamma (double a, double b){
-    double result = gsl_ran_gamma(rng.gsl_generator, a, b);
+    double result = gsl_ran_gamma(generator(), a, b);
 //     util::streamValidate(result);
     return result;
 }
 
+void random::gamma (double a, double b, double* out, size_t n){
+    gsl_rng *gen = generator();
+    for( size_t i = 0; i < n; ++i )
+	out[i] = gsl_ran_gamma(gen, a, b);
+}
+void random::gamma (const double* a, const double* b, double* out, size_t n){
+    gsl_rng *gen = generator();
+    for( size_t i = 0; i < n; ++i )
+	out[i] = gsl_ran_gamma(gen, a[i], b[i]);
+}
+
 double random::log_normal (double mu, double sigma){
 /*# ifdef OM_RANDOM_USE_BOOST
     // This doesn't work: boost version takes mean and sigma while gsl version takes mu and sigma.
     boost::lognormal_distribution<> dist (mean, std);
     return dist (boost_generator);
 # else*/
-    double result = gsl_ran_lognormal (rng.gsl_generator, mu, sigma);
+    double result = gsl_ran_lognormal (generator(), mu, sigma);
 //     util::streamValidate(result);
     return result;
 //# endif
@@ -224,7 +517,7 @@ double random::sampleFromLogNormal(double normp, double meanlog, double stdlog){
 }
 
 double random::beta (double a, double b){
-    double result = gsl_ran_beta (rng.gsl_generator,a,b);
+    double result = gsl_ran_beta (generator(),a,b);
 //     util::streamValidate(result);
     return result;
 }
@@ -240,7 +533,7 @@ int random::poisson(double lambda){
 	//This would lead to an inifinite loop in gsl_ran_poisson
 	throw TRACED_EXCEPTION( "lambda is inf", Error::InfLambda );
     }
-    int result = gsl_ran_poisson (rng.gsl_generator, lambda);
+    int result = gsl_ran_poisson (generator(), lambda);
 //     util::streamValidate(result);
     return result;
 }
@@ -259,11 +552,11 @@ int random::uniform(int n){
 }
 
 double random::exponential(double mean){
-    return gsl_ran_exponential(rng.gsl_generator, mean);
+    return gsl_ran_exponential(generator(), mean);
 }
 
 double random::weibull(double lambda, double k){
-    return gsl_ran_weibull( rng.gsl_generator, lambda, k );
+    return gsl_ran_weibull( generator(), lambda, k );
 }
 
 } }
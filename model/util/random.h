@@ -32,10 +32,55 @@ namespace random {
     /// Reseed the random-number-generator with seed (usually InputData.getISeed()).
     void seed (uint32_t seed);
     
+    /** Use the counter-based generator instead of the default (Mersenne
+     * twister). Must be called before seed().
+     * 
+     * The counter-based generator (Philox4x32-10) computes each block of
+     * output from a key and a counter, so that a stream of numbers can be
+     * selected without generating those of other streams. See beginStream().
+     * Its state is stored in the checkpoint itself (no seed files). */
+    void useCounterGenerator ();
+    
+    /** In checkpoints using the default generator, the generator state is
+     * written to the file seedN where N is seedFileNumber. If seedFileNumber
+     * is negative, the state is written to the stream instead (for
+     * warm-up snapshots, which must be self-contained). */
     void checkpoint (istream& stream, int seedFileNumber);
     void checkpoint (ostream& stream, int seedFileNumber);
     //@}
     
+    ///@brief Independent streams (counter-based generator only)
+    //@{
+    /** Purpose of a stream; streams for one individual and time step differ
+     * by purpose. Values must not be changed (they affect results). */
+    enum StreamPurpose {
+        HUMAN_BIRTH = 1,
+        HUMAN_UPDATE = 2
+    };
+    
+    /** With the counter-based generator, take subsequent numbers drawn by
+     * the calling thread from the stream identified by (seed, id, time,
+     * purpose) until endStream() is called. The stream does not depend on
+     * numbers drawn elsewhere, and thus not on thread scheduling.
+     * 
+     * Each combination of arguments should be used at most once per run.
+     * With the default generator these functions do nothing. */
+    void beginStream (uint32_t id, StreamPurpose purpose, SimTime time);
+    /** Return to the calling thread's usual stream. */
+    void endStream ();
+    
+    /** Calls beginStream() on construction and endStream() on destruction. */
+    class StreamScope {
+    public:
+        StreamScope (uint32_t id, StreamPurpose purpose, SimTime time){
+            beginStream (id, purpose, time);
+        }
+        ~StreamScope (){
+            endStream ();
+        }
+    };
+    //@}
+    
     ///@brief Random number distributions
     //@{
     /** Generate a random number in the range [0,1). */
@@ -89,5 +134,22 @@ namespace random {
      */
     double weibull( double lambda, double k );
     //@}
+    
+    /** @brief Batch sampling
+     * 
+     * These fill out[0], ..., out[n-1] with independent variates. Results
+     * are identical to those of n calls to the single-variate version (in
+     * order), but the generator is looked up once and the distribution
+     * functions are called directly, which is cheaper in hot loops.
+     * 
+     * Versions taking arrays of parameters use parameters a[i], b[i] (or
+     * mean[i], std[i]) for variate i. */
+    //@{
+    void uniform_01 (double* out, size_t n);
+    void gauss (double mean, double std, double* out, size_t n);
+    void gauss (const double* mean, const double* std, double* out, size_t n);
+    void gamma (double a, double b, double* out, size_t n);
+    void gamma (const double* a, const double* b, double* out, size_t n);
+    //@}
 }
 } }
@@ -26,6 +26,7 @@
 #include <cstdio>	// perror
 #include <pthread.h>
 #include <unistd.h>     // sleep
+#include <sys/time.h>   // gettimeofday
 #endif
 
 #include "util/timer.h"
@@ -77,6 +78,13 @@ void timer::stopCheckpoint (){
   GetExitCodeThread(timer_threadCP, &thread_result);
 }
 
+double timer::wallTime (){
+  LARGE_INTEGER count, frequency;
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&frequency);
+  return static_cast<double>(count.QuadPart) / static_cast<double>(frequency.QuadPart);
+}
+
 #else
 
 //Pthread version
@@ -114,5 +122,11 @@ void timer::stopCheckpoint (){
   }
 }
 
+double timer::wallTime (){
+  timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
 #endif
 } }
@@ -24,6 +24,10 @@
 namespace OM { namespace util { namespace timer {
   void startCheckpoint ();
   void stopCheckpoint ();
+  
+  /** Wall-clock time in seconds since some arbitrary origin; only useful for
+   * measuring durations. */
+  double wallTime ();
 } } }
 
 #endif
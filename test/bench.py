@@ -0,0 +1,250 @@
+#!/usr/bin/python
+# -*- coding: utf-8 -*-
+
+# This file is part of OpenMalaria.
+#
+# Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+# Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+#
+# OpenMalaria is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or (at
+# your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+# Performance benchmarks: run a set of test scenarios (by default
+# BENCH_SCENARIOS below), optionally at a different population size, and
+# record wall time, time per simulation phase (from openMalaria's
+# --phase-times) and peak resident memory. Results can be saved as a baseline
+# and later runs compared against it; a run is a regression if any measure
+# exceeds the baseline by more than the given threshold.
+#
+# Baselines are specific to a machine and build configuration, so none is
+# stored in the repository; create one with --save-baseline.
+#
+# Exit status:
+#	0 - all runs succeeded and no regressions found
+#	1 - a run failed or a regression was found
+#	-1 - unable to run
+
+import sys
+import os
+import re
+import tempfile
+import time
+import subprocess
+import shutil
+from optparse import OptionParser
+
+# replaced by CMake; run the version it puts in the build/test/ dir.
+testSrcDir="@CMAKE_CURRENT_SOURCE_DIR@"
+testBuildDir="@CMAKE_CURRENT_BINARY_DIR@"
+if not os.path.isdir(testSrcDir) or not os.path.isdir(testBuildDir):
+    print "Don't run this script directly; configure CMake then use the version in the CMake build dir."
+    sys.exit(-1)
+
+sys.path[0]=testBuildDir
+import run
+
+# Scenarios run by default: a spread of within-host, vector and genotype
+# models which between them exercise most hot paths.
+BENCH_SCENARIOS=["5", "Penny", "Molineaux", "Empirical", "VecTest", "VecFullTest", "Genotypes"]
+
+# Phases reported by --phase-times which are compared against the baseline.
+PHASES=["ONE_LIFE_SPAN", "TRANSMISSION_INIT", "MAIN_PHASE"]
+
+# Runs shorter than this (seconds) are not checked for time regressions:
+# their relative noise is too large.
+MIN_CHECKED_TIME=0.5
+
+def readPhaseTimes(fileName):
+    times=dict()
+    for line in open(fileName):
+        parts=line.split('\t')
+        if len(parts) == 2:
+            times[parts[0]]=float(parts[1])
+    return times
+
+def runOnce(name,scenarioSrc,popSize,omOptions):
+    """Run openMalaria once; return a dict of measures or None on failure."""
+    schemaName=run.getSchemaName(scenarioSrc)
+    scenarioSchema=os.path.abspath(os.path.join(testSrcDir,'../schema',schemaName))
+    if not os.path.isfile(scenarioSchema):
+        scenarioSchema=os.path.abspath(os.path.join(testBuildDir,'../schema',schemaName))
+    simDir = tempfile.mkdtemp(prefix=name+'-bench-', dir=testBuildDir)
+    try:
+        run.linkOrCopy (scenarioSchema, os.path.join(simDir,schemaName))
+        scenario=scenarioSrc
+        if popSize is not None:
+            # Write a copy with a different population size
+            scenario=os.path.join(simDir,"scenario.xml")
+            text=open(scenarioSrc).read()
+            text,n=re.subn(r'popSize="[0-9]+"','popSize="%d"' % popSize,text)
+            if n != 1:
+                raise run.RunError("%s: can't find popSize attribute" % scenarioSrc)
+            open(scenario,'w').write(text)
+        phaseFile=os.path.join(simDir,"phases.txt")
+        cmd=[run.openMalariaExec,"--resource-path",os.path.abspath(testSrcDir),
+             "--scenario",scenario,"--phase-times",phaseFile]+omOptions
+        startTime=time.time()
+        proc=subprocess.Popen (cmd, shell=False, cwd=simDir, stdout=open(os.devnull,'w'))
+        rss=None
+        if hasattr(os,'wait4'):
+            pid,status,usage=os.wait4(proc.pid,0)
+            ret=os.WEXITSTATUS(status) if os.WIFEXITED(status) else -1
+            rss=usage.ru_maxrss
+            if sys.platform == 'darwin':
+                rss/=1024       # bytes on OS X, kiB elsewhere
+        else:
+            ret=proc.wait()
+        wallTime=time.time()-startTime
+        if ret != 0:
+            print "\033[1;31m%s: non-zero exit status: %d\033[0;0m" % (name,ret)
+            return None
+        result=dict()
+        result["WALL"]=wallTime
+        phases=readPhaseTimes(phaseFile)
+        for phase in PHASES:
+            result[phase]=phases.get(phase,0.0)
+        if rss is not None:
+            result["RSS_KB"]=float(rss)
+        return result
+    finally:
+        shutil.rmtree(simDir)
+
+def bench(name,options,omOptions):
+    scenarioSrc=os.path.abspath(os.path.join(testSrcDir,"scenario%s.xml" % name))
+    if not os.path.isfile(scenarioSrc):
+        raise run.RunError('No such scenario file '+scenarioSrc)
+    best=None
+    for i in range(options.repeats):
+        result=runOnce(name,scenarioSrc,options.popSize,omOptions)
+        if result is None:
+            return None
+        if best is None:
+            best=result
+        else:
+            # Take the minimum of each measure over repeats: noise only
+            # makes runs slower.
+            for k,v in result.iteritems():
+                best[k]=min(best[k],v)
+    return best
+
+def key(name,options):
+    return name if options.popSize is None else "%s@%d" % (name,options.popSize)
+
+def readBaseline(fileName):
+    baseline=dict()
+    for line in open(fileName):
+        parts=line.rstrip('\n').split('\t')
+        if len(parts) == 3 and not line.startswith('#'):
+            baseline[(parts[0],parts[1])]=float(parts[2])
+    return baseline
+
+def writeBaseline(fileName,results):
+    f=open(fileName,'w')
+    f.write("# OpenMalaria benchmark baseline: scenario[@popSize]\tmeasure\tvalue\n")
+    for name in sorted(results.iterkeys()):
+        for measure in sorted(results[name].iterkeys()):
+            f.write("%s\t%s\t%g\n" % (name,measure,results[name][measure]))
+    f.close()
+
+def compare(results,baseline,options):
+    """Print a comparison; return number of regressions."""
+    regressions=0
+    for name in sorted(results.iterkeys()):
+        for measure in sorted(results[name].iterkeys()):
+            value=results[name][measure]
+            if (name,measure) not in baseline:
+                print "  %-24s %-18s %10.3f   (no baseline)" % (name,measure,value)
+                continue
+            base=baseline[(name,measure)]
+            change=(value-base)/base if base > 0.0 else 0.0
+            if measure == "RSS_KB":
+                threshold=options.rssThreshold
+                checked=True
+            else:
+                threshold=options.threshold
+                checked=base >= MIN_CHECKED_TIME
+            bad=checked and change > threshold
+            if bad:
+                regressions+=1
+            print "  %-24s %-18s %10.3f %10.3f %+7.1f%%%s" % (name,measure,value,base,100.0*change,
+                "   \033[1;31mREGRESSION\033[0;0m" if bad else "")
+    return regressions
+
+def main(args):
+    #First separate OpenMalaria args and args for this script
+    omArgsBegin = len(args)
+    for i in range(0,len(args)-1):
+        if args[i] == "--":
+            omArgsBegin = i+1
+            break
+    omOptions=args[omArgsBegin:]
+    args=[a for a in args[1:omArgsBegin] if a != "--"]
+
+    parser = OptionParser(usage="Usage: %prog [options] [scenarios] [-- openMalaria options]",
+            description="Run benchmark scenarios (default: "+" ".join(BENCH_SCENARIOS)+
+            ") and compare against a baseline. Scenario names are as for run.py.")
+    parser.add_option("-p","--population", type="int", dest="popSize", default=None,
+                      help="Run scenarios with this population size instead of that in the scenario file")
+    parser.add_option("-r","--repeats", type="int", dest="repeats", default=3,
+                      help="Number of runs per scenario; the minimum of each measure is used (default 3)")
+    parser.add_option("-b","--baseline", dest="baseline",
+                      default=os.path.join(testBuildDir,"benchBaseline.txt"),
+                      help="Baseline file (default: benchBaseline.txt in the build's test dir)")
+    parser.add_option("-s","--save-baseline", action="store_true", dest="save", default=False,
+                      help="Save results as the baseline (merged with existing entries) instead of comparing")
+    parser.add_option("-t","--threshold", type="float", dest="threshold", default=0.2,
+                      help="Relative slow-down of wall or phase time counted as a regression (default 0.2)")
+    parser.add_option("--rss-threshold", type="float", dest="rssThreshold", default=0.2,
+                      help="Relative increase of peak memory counted as a regression (default 0.2)")
+    (options, others) = parser.parse_args(args=args)
+    if not others:
+        others=BENCH_SCENARIOS
+
+    try:
+        results=dict()
+        failed=0
+        for name in others:
+            print "\033[0;33m%s\033[0;0m" % key(name,options)
+            result=bench(name,options,omOptions)
+            if result is None:
+                failed+=1
+            else:
+                results[key(name,options)]=result
+
+        baseline=dict()
+        if os.path.isfile(options.baseline):
+            baseline=readBaseline(options.baseline)
+        if options.save:
+            for name,result in results.iteritems():
+                for measure,value in result.iteritems():
+                    baseline[(name,measure)]=value
+            merged=dict()
+            for (name,measure),value in baseline.iteritems():
+                merged.setdefault(name,dict())[measure]=value
+            writeBaseline(options.baseline,merged)
+            print "Baseline written to "+options.baseline
+            regressions=0
+        else:
+            print "  %-24s %-18s %10s %10s %8s" % ("scenario","measure","value","baseline","change")
+            regressions=compare(results,baseline,options)
+            if regressions:
+                print "\033[1;31m%d regression(s)\033[0;0m" % regressions
+
+        return 1 if (failed or regressions) else 0
+    except run.RunError,e:
+        print str(e)
+        return -1
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
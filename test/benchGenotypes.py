@@ -0,0 +1,45 @@
+#!/usr/bin/python
+# -*- coding: utf-8 -*-
+
+# This file is part of OpenMalaria.
+#
+# Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+# Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+#
+# OpenMalaria is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or (at
+# your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+# Compare run time of the scalar and vector (--vector-genotypes) kernels of
+# the mosquito transmission update (see benchOption.py). By default runs
+# scenarioGenotypes.xml; other scenario names (as for run.py) or paths may be
+# given, e.g. genotypes10000/scenarioGenotypes10000.xml.
+# Exit status:
+#	0 - outputs of the two kernels agree (to compareOutput.py's precision)
+#	1 - outputs differ or a run failed
+#	-1 - unable to run
+
+import sys
+import os
+
+# replaced by CMake; run the version it puts in the build/test/ dir.
+testBuildDir="@CMAKE_CURRENT_BINARY_DIR@"
+if not os.path.isdir(testBuildDir):
+    print "Don't run this script directly; configure CMake then use the version in the CMake build dir."
+    sys.exit(-1)
+
+sys.path[0]=testBuildDir
+import benchOption
+
+if __name__ == "__main__":
+    sys.exit(benchOption.main(sys.argv, "--vector-genotypes", ["Genotypes"]))
@@ -0,0 +1,136 @@
+#!/usr/bin/python
+# -*- coding: utf-8 -*-
+
+# This file is part of OpenMalaria.
+#
+# Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+# Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+#
+# OpenMalaria is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or (at
+# your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+# Compare run time and outputs of openMalaria without and with some option,
+# e.g. to check that an optimisation switched on by a command-line option
+# is faster and does not (significantly) change results:
+#	benchOption.py --option=--tabulate-decay IRS30 2ITNs
+# Scenario names are as for run.py, or paths relative to the test dir.
+# Exit status:
+#	0 - outputs of the two configurations agree (to compareOutput.py's precision)
+#	1 - outputs differ or a run failed
+#	-1 - unable to run
+
+import sys
+import os
+import tempfile
+import time
+import subprocess
+import shutil
+from optparse import OptionParser
+
+# replaced by CMake; run the version it puts in the build/test/ dir.
+testSrcDir="@CMAKE_CURRENT_SOURCE_DIR@"
+testBuildDir="@CMAKE_CURRENT_BINARY_DIR@"
+if not os.path.isdir(testSrcDir) or not os.path.isdir(testBuildDir):
+    print "Don't run this script directly; configure CMake then use the version in the CMake build dir."
+    sys.exit(-1)
+
+sys.path[0]=testBuildDir
+import run
+import compareOutput
+
+def runOnce(scenarioSrc,name,omOptions):
+    """Run openMalaria once in a temporary directory; return (ret, seconds, path of output.txt)."""
+    schemaName=run.getSchemaName(scenarioSrc)
+    scenarioSchema=os.path.abspath(os.path.join(testSrcDir,'../schema',schemaName))
+    if not os.path.isfile(scenarioSchema):
+        scenarioSchema=os.path.abspath(os.path.join(testBuildDir,'../schema',schemaName))
+    simDir = tempfile.mkdtemp(prefix=name+'-bench-', dir=testBuildDir)
+    run.linkOrCopy (scenarioSchema, os.path.join(simDir,schemaName))
+    cmd=[run.openMalariaExec,"--resource-path",os.path.abspath(testSrcDir),"--scenario",scenarioSrc]+omOptions
+    startTime=time.time()
+    ret=subprocess.call (cmd, shell=False, cwd=simDir)
+    return ret, time.time()-startTime, simDir
+
+def bench(name,option,options,omOptions):
+    scenarioSrc=os.path.abspath(os.path.join(testSrcDir,"scenario%s.xml" % name))
+    if not os.path.isfile(scenarioSrc):
+        scenarioSrc=os.path.abspath(os.path.join(testSrcDir,name))
+        if not os.path.isfile(scenarioSrc):
+            raise run.RunError('No such scenario file '+name)
+        name=os.path.splitext(os.path.basename(name))[0]
+
+    configs=[("without",[]), ("with",option.split())]
+    times=dict()
+    outputs=dict()
+    for (config,configOptions) in configs:
+        times[config]=[]
+        for i in range(options.repeats):
+            ret,t,simDir=runOnce(scenarioSrc,name,configOptions+omOptions)
+            if ret != 0:
+                print "\033[1;31m%s (%s %s): non-zero exit status: %d\033[0;0m" % (name,config,option,ret)
+                return 1
+            times[config].append(t)
+            if config in outputs:
+                shutil.rmtree(simDir)
+            else:
+                outputs[config]=simDir
+
+    without=min(times["without"])
+    withOpt=min(times["with"])
+    print "%s: without %s %.2fs, with %.2fs (best of %d); speed-up %.2f" % (name,option,without,withOpt,options.repeats,without/withOpt)
+
+    ret,ident=compareOutput.main(os.path.join(outputs["without"],"output.txt"),
+                                 os.path.join(outputs["with"],"output.txt"))
+    for simDir in outputs.itervalues():
+        shutil.rmtree(simDir)
+    return ret
+
+def main(args,option=None,defaultScenarios=[]):
+    """Run the benchmark. option and defaultScenarios are defaults for the
+    --option argument and scenarios, used when not given in args."""
+    #First separate OpenMalaria args and args for this script
+    omArgsBegin = len(args)
+    for i in range(0,len(args)-1):
+        if args[i] == "--":
+            omArgsBegin = i+1
+            break
+    omOptions=args[omArgsBegin:]
+    parser = OptionParser(usage="Usage: %prog [options] [scenarios] [-- openMalaria options]")
+    parser.add_option("-r","--repeats", type="int", dest="repeats", default=3,
+                      help="Number of runs per configuration; the fastest is reported (default 3)")
+    parser.add_option("-o","--option", dest="option", default=option,
+                      help="openMalaria option(s) to compare against a run without"+
+                      (" (default %s)" % option if option else ""))
+    (options, others) = parser.parse_args(args=args[1:omArgsBegin])
+    if not options.option:
+        parser.error("no option given (use --option)")
+    if not others:
+        others=defaultScenarios
+    if not others:
+        parser.error("no scenarios given")
+
+    try:
+        retVal=0
+        for name in others:
+            if name == "--":
+                continue
+            r=bench(name,options.option,options,omOptions)
+            retVal = r if retVal == 0 else retVal
+        return retVal
+    except run.RunError,e:
+        print str(e)
+        return -1
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv, "--tabulate-decay", ["IRS30", "2ITNs"]))
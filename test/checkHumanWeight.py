@@ -0,0 +1,109 @@
+#!/usr/bin/python
+# -*- coding: utf-8 -*-
+
+# This file is part of OpenMalaria.
+#
+# Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+# Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+#
+# OpenMalaria is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or (at
+# your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+# Check that vector initialisation does not depend on --human-weight: run a
+# vector scenario with weight 1 and weight n and compare totals of the
+# vector-model outputs (emergence N_v0 and simulated EIR). Outputs are
+# stochastic, so only approximate agreement is expected; a population sum
+# which misses the weight is off by around a factor n.
+#	checkHumanWeight.py [--weight=n] [--tolerance=t] [scenarios]
+# Exit status:
+#	0 - totals agree to the relative tolerance
+#	1 - totals differ or a run failed
+#	-1 - unable to run
+
+import sys
+import os
+import shutil
+from optparse import OptionParser
+
+# replaced by CMake; run the version it puts in the build/test/ dir.
+testSrcDir="@CMAKE_CURRENT_SOURCE_DIR@"
+testBuildDir="@CMAKE_CURRENT_BINARY_DIR@"
+if not os.path.isdir(testSrcDir) or not os.path.isdir(testBuildDir):
+    print "Don't run this script directly; configure CMake then use the version in the CMake build dir."
+    sys.exit(-1)
+
+sys.path[0]=testBuildDir
+import run
+from readOutput import readEntries   # run sets the path to util/
+import benchOption
+
+# measure numbers (see OutputMeasures.hpp): Vector_Nv0, simulatedEIR
+MEASURES={31:"Vector_Nv0", 36:"simulatedEIR"}
+
+def totals(fname):
+    """Sum each measure of MEASURES over surveys and groups."""
+    sums=dict((m,0.0) for m in MEASURES)
+    for key,value in readEntries(fname).iteritems():
+        if key.a in sums:
+            sums[key.a] += value
+    return sums
+
+def check(name,options):
+    scenarioSrc=os.path.abspath(os.path.join(testSrcDir,"scenario%s.xml" % name))
+    if not os.path.isfile(scenarioSrc):
+        raise run.RunError('No such scenario file '+name)
+
+    sums=dict()
+    for weight in [1, options.weight]:
+        ret,t,simDir=benchOption.runOnce(scenarioSrc,name,["--human-weight=%d" % weight])
+        if ret != 0:
+            print "\033[1;31m%s (--human-weight=%d): non-zero exit status: %d\033[0;0m" % (name,weight,ret)
+            shutil.rmtree(simDir)
+            return 1
+        sums[weight]=totals(os.path.join(simDir,"output.txt"))
+        shutil.rmtree(simDir)
+
+    retVal=0
+    for m,mName in MEASURES.iteritems():
+        a=sums[1][m]
+        b=sums[options.weight][m]
+        if abs(a-b) > options.tolerance * max(abs(a),abs(b)):
+            print "\033[1;31m%s: %s total %g with weight 1, %g with weight %d\033[0;0m" % (name,mName,a,b,options.weight)
+            retVal=1
+        else:
+            print "%s: %s total %g with weight 1, %g with weight %d" % (name,mName,a,b,options.weight)
+    return retVal
+
+def main(args):
+    parser = OptionParser(usage="Usage: %prog [options] [scenarios]")
+    parser.add_option("-w","--weight", type="int", dest="weight", default=4,
+                      help="Human weight to compare against weight 1 (default 4)")
+    parser.add_option("-t","--tolerance", type="float", dest="tolerance", default=0.3,
+                      help="Maximum relative difference of totals (default 0.3)")
+    (options, others) = parser.parse_args(args=args[1:])
+    if not others:
+        others=["VecTest"]
+
+    try:
+        retVal=0
+        for name in others:
+            r=check(name,options)
+            retVal = r if retVal == 0 else retVal
+        return retVal
+    except run.RunError,e:
+        print str(e)
+        return -1
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
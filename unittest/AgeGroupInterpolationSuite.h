@@ -74,6 +74,27 @@ public:
         }
     }
     
+    void testTabulated () {
+        agvElt->setInterpolation( "linear" );
+        AgeGroupInterpolator o;
+        o.set( *agvElt, "testTabulated" );
+        
+        AgeGroupInterpolator::setTabulate( true );
+        AgeGroupInterpolator t;
+        t.set( *agvElt, "testTabulated" );
+        AgeGroupInterpolator::setTabulate( false );
+        
+        // whole numbers of steps use the table
+        for( int i = 0; i <= sim::maxHumanAge().inSteps(); ++i ){
+            double age = sim::fromTS( i ).inYears();
+            TS_ASSERT_EQUALS( t.eval( age ), o.eval( age ) );
+        }
+        // other ages don't
+        for( size_t i = 0; i < testLen; ++i ){
+            TS_ASSERT_EQUALS( t.eval( testAges[ i ] ), o.eval( testAges[ i ] ) );
+        }
+    }
+    
 private:
     static const size_t dataLen = 5;
     static const size_t testLen = 8;
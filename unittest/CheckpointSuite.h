@@ -24,6 +24,7 @@
 
 #include <cxxtest/TestSuite.h>
 #include "util/checkpoint.h"
+#include "util/checkpoint_containers.h"
 #include <sstream>
 #include <limits>
 #include <climits>
@@ -55,6 +56,27 @@ public:
 	orig.assert_equals (*test);
     }
     
+    void testCheckpointKeepSize () {
+	vector<int> a, b(2, -1), c(4, -1);
+	a.push_back (5);
+	a.push_back (6);
+	a.push_back (7);
+	std::stringstream ss;
+	checkpointKeepSize (a, static_cast<ostream&>(ss));
+	checkpointKeepSize (a, static_cast<ostream&>(ss));
+	
+	// shorter: extra stored elements are discarded
+	checkpointKeepSize (b, static_cast<istream&>(ss));
+	TS_ASSERT_EQUALS (b.size(), 2u);
+	TS_ASSERT_EQUALS (b[0], 5);
+	TS_ASSERT_EQUALS (b[1], 6);
+	// longer: other elements are unchanged
+	checkpointKeepSize (c, static_cast<istream&>(ss));
+	TS_ASSERT_EQUALS (c.size(), 4u);
+	TS_ASSERT_EQUALS (c[2], 7);
+	TS_ASSERT_EQUALS (c[3], -1);
+    }
+    
     struct TestObject {
 	TestObject () : x(-23263) {}
 	virtual ~TestObject () {}
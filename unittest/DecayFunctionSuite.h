@@ -130,6 +130,25 @@ public:
         TS_ASSERT_APPROX( df->eval( sim::fromYearsI(20), dHet ), 0.0 );
     }
     
+    void testTabulated () {
+        // Hill with k=1.6 has unbounded curvature at 0, so isn't tabulated
+        const char* funcs[] = { "exponential", "weibull", "hill", "smooth-compact" };
+        const bool tabulated[] = { true, true, false, true };
+        for( size_t f = 0; f < sizeof(funcs)/sizeof(funcs[0]); ++f ){
+            dfElt.setFunction( funcs[f] );
+            df = DecayFunction::makeObject( dfElt, "DecayFunctionSuite" );
+            DecayFuncHet dHet = df->hetSample();
+            // every day: ages fall at all positions within table steps
+            vector<double> exact;
+            for( int days = 0; days < 30*365; ++days )
+                exact.push_back( df->eval( sim::fromDays(days), dHet ) );
+            df->tabulate();
+            TS_ASSERT_EQUALS( !df->table.empty(), tabulated[f] );
+            for( int days = 0; days < 30*365; ++days )
+                TS_ASSERT_DELTA( df->eval( sim::fromDays(days), dHet ), exact[days], 1e-6 );
+        }
+    }
+    
 private:
     scnXml::DecayFunction dfElt;
     auto_ptr<DecayFunction> df;
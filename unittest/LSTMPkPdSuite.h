@@ -26,6 +26,7 @@
 #include <cxxtest/TestSuite.h>
 #include "PkPd/LSTMModel.h"
 #include "UnittestUtil.h"
+#include "util/parallel.h"
 #include "ExtraAsserts.h"
 #include <limits>
 
@@ -79,6 +80,15 @@ public:
 	TS_ASSERT_APPROX (proxy->getDrugFactor (genotype), 0.03564073617400945);
     }
     
+    void testOralCachedFactor () {
+        // the factor is cached per day; a new dose must replace the cached value
+	UnittestUtil::medicate( *proxy, MF_index, 1500, 0, NaN, massAt21 );
+	double factor = proxy->getDrugFactor (genotype);
+	TS_ASSERT_EQUALS (proxy->getDrugFactor (genotype), factor);
+	UnittestUtil::medicate( *proxy, MF_index, 1500, 0, NaN, massAt21 );
+	TS_ASSERT_APPROX (proxy->getDrugFactor (genotype), 0.03564073617400945);
+    }
+    
     void testOralDecayed () {
 	UnittestUtil::medicate( *proxy, MF_index, 3000, 0, NaN, massAt21 );
 	proxy->decayDrugs ();
@@ -115,6 +125,27 @@ public:
         TS_ASSERT_APPROX (proxy->getDrugFactor(genotype), 0.10315895127530212);
     }
     
+    void testIVThreaded (){
+#ifdef _OPENMP
+        // IV factors are cached per thread; check several threads computing
+        // the same schedule concurrently all get the result of testIV.
+        const int nThreads = 4, nModels = 32;
+        util::parallel::init( nThreads );
+        LSTMDrugType::clear();
+        UnittestUtil::PkPdSuiteSetup();     // allocates per-thread caches
+        vector<double> factors( nModels );
+#pragma omp parallel for schedule(static)
+        for( int i = 0; i < nModels; ++i ){
+            LSTMModel model;
+            UnittestUtil::medicate( model, MF_index, 50, 0, 1, massAt21 );
+            factors[i] = model.getDrugFactor( genotype );
+        }
+        util::parallel::init( 1 );
+        for( int i = 0; i < nModels; ++i )
+            TS_ASSERT_APPROX (factors[i], 0.10315895127530212);
+#endif
+    }
+    
     void testCombined (){
         UnittestUtil::medicate( *proxy, MF_index, 50, 0, 0.5, massAt21 );
         UnittestUtil::medicate( *proxy, MF_index, 1500, 0.5, NaN, massAt21 );
@@ -46,6 +46,7 @@ public:
     }
     void tearDown () {
         util::random::seed(0);  // make sure nothing else uses this seed/reports
+        MolineauxInfection::setVectorKernel( false );
     }
     
     static void readVector(std::vector<double>& vec, const char* file){
@@ -88,6 +89,34 @@ public:
         delete infection;
     }
     
+    void testVectorKernel(){
+        UnittestUtil::MolineauxWHM_setup( "original", false );
+        
+        // Each day, update a copy of the infection using the vector kernel
+        // and check its state against that from the scalar kernel.
+        MolineauxInfection* infection = new MolineauxInfection (0xFFFFFFFF);
+        bool extinct = false;
+        SimTime now = sim::ts0();
+        do{
+            MolineauxInfection* copy = new MolineauxInfection (*infection);
+            MolineauxInfection::setVectorKernel( true );
+            bool copyExtinct = copy->update(1.0, now, 71.43);
+            MolineauxInfection::setVectorKernel( false );
+            extinct = infection->update(1.0, now, 71.43);
+            
+            TS_ASSERT_EQUALS( copyExtinct, extinct );
+            TS_ASSERT_EQUALS( copy->nVariants, infection->nVariants );
+            TS_ASSERT_APPROX_TOL( copy->getDensity(), infection->getDensity(), 1e-6, 1e-10 );
+            for( size_t i = 0; i < MolineauxInfection::v; ++i ){
+                TS_ASSERT_APPROX_TOL( copy->Pi1[i], infection->Pi1[i], 1e-6, 1e-10 );
+                TS_ASSERT_APPROX_TOL( copy->Pi2[i], infection->Pi2[i], 1e-6, 1e-10 );
+            }
+            delete copy;
+            now += sim::oneDay();
+        }while(!extinct);
+        delete infection;
+    }
+    
     void testMolOrig(){
         UnittestUtil::MolineauxWHM_setup( "original", false );
         MolInfStats stats( 200 );
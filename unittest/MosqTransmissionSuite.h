@@ -0,0 +1,116 @@
+/*
+ This file is part of OpenMalaria.
+ 
+ Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+ 
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef Hmod_MosqTransmissionSuite
+#define Hmod_MosqTransmissionSuite
+
+#include <cxxtest/TestSuite.h>
+#include "UnittestUtil.h"
+#include "ExtraAsserts.h"
+#include "Transmission/Anopheles/MosqTransmission.h"
+#include "WithinHost/Genotypes.h"
+
+using namespace OM::Transmission::Anopheles;
+using OM::WithinHost::Genotypes;
+
+/** Tests of MosqTransmission which don't need the vector life-cycle model
+ * (see MosqLifeCycleSuite). */
+class MosqTransmissionSuite : public CxxTest::TestSuite
+{
+public:
+    void setUp () {
+        UnittestUtil::initTime(1);
+        Genotypes::initSingle();
+        Genotypes::N_genotypes = nGenotypes;
+        
+        // State as after several days of MosqTransmission::update(), with
+        // arbitrary values varying by day and genotype; fArray, ftauArray
+        // and uninfected_v are used as cached by update().
+        mt.mosqRestDuration = sim::fromDays(3);
+        mt.EIPDuration = sim::fromDays(10);
+        mt.N_v_length = mt.EIPDuration + mt.mosqRestDuration;
+        mt.minInfectedThreshold = 0.5;
+        const SimTime len = mt.N_v_length;
+        mt.P_A.resize( len );
+        mt.P_df.resize( len );
+        mt.N_v.resize( len );
+        mt.P_dif.resize( len, nGenotypes );
+        mt.O_v.resize( len, nGenotypes );
+        mt.S_v.resize( len, nGenotypes );
+        mt.fArray.resize( mt.EIPDuration - mt.mosqRestDuration + sim::oneDay() );
+        mt.ftauArray.resize( mt.EIPDuration );
+        mt.uninfected_v.resize( len );
+        for( SimTime t = sim::zero(); t < len; t += sim::oneDay() ){
+            const double d = t.inDays();
+            mt.P_A[t] = 0.6 + 0.01 * d;
+            mt.P_df[t] = 0.2 - 0.005 * d;
+            mt.N_v[t] = 5000.0 + 37.0 * d;
+            mt.uninfected_v[t] = 4000.0 + 29.0 * d;
+            for( size_t g = 0; g < nGenotypes; ++g ){
+                mt.P_dif.at(t,g) = 0.002 * (1.0 + 0.1 * g) + 0.0003 * d;
+                mt.O_v.at(t,g) = 100.0 + 11.0 * d + 7.0 * g;
+                mt.S_v.at(t,g) = 10.0 + 1.3 * d + 0.9 * g;
+            }
+        }
+        for( SimTime t = sim::zero(); t < mt.fArray.size(); t += sim::oneDay() )
+            mt.fArray[t] = 1.0 / (1.0 + t.inDays());
+        for( SimTime t = sim::zero(); t < mt.ftauArray.size(); t += sim::oneDay() )
+            mt.ftauArray[t] = 0.5 / (1.0 + t.inDays());
+    }
+    void tearDown () {
+        Genotypes::initSingle();
+    }
+    
+    /** updateGenotypesVector() should agree with updateGenotypesScalar() to
+     * rounding error, starting from the same state. */
+    void testVectorKernel () {
+        for( int day = 0; day < 20; ++day ){
+            // as in MosqTransmission::update()
+            const SimTime d0 = sim::fromDays(day), d1 = d0 + sim::oneDay();
+            const SimTime d1Mod = d1 + mt.N_v_length;
+            const SimTime t1 = mod_nn(d1, mt.N_v_length);
+            const SimTime t0 = mod_nn(d0, mt.N_v_length);
+            const SimTime ttau = mod_nn(d1Mod - mt.mosqRestDuration, mt.N_v_length);
+            
+            for( int dynamic = 0; dynamic < 2; ++dynamic ){
+                MosqTransmission scalar( mt ), vec( mt );
+                vector<double> scalarEIR( nGenotypes, 1.0 ), vecEIR( nGenotypes, 1.0 );
+                scalar.updateGenotypesScalar( d1Mod, t0, t1, ttau, dynamic, scalarEIR, 0.01 );
+                vec.updateGenotypesVector( d1Mod, t0, t1, ttau, dynamic, vecEIR, 0.01 );
+                for( size_t g = 0; g < nGenotypes; ++g ){
+                    TS_ASSERT_APPROX_TOL( vec.O_v.at(t1,g), scalar.O_v.at(t1,g), 1e-12, 1e-12 );
+                    TS_ASSERT_APPROX_TOL( vec.S_v.at(t1,g), scalar.S_v.at(t1,g), 1e-12, 1e-12 );
+                    TS_ASSERT_APPROX_TOL( vecEIR[g], scalarEIR[g], 1e-12, 1e-12 );
+                }
+            }
+            
+            // advance the state as update() would (with the scalar kernel)
+            vector<double> partialEIR( nGenotypes, 0.0 );
+            mt.updateGenotypesScalar( d1Mod, t0, t1, ttau, true, partialEIR, 0.01 );
+        }
+    }
+    
+private:
+    static const size_t nGenotypes = 5;
+    MosqTransmission mt;
+};
+
+#endif
@@ -0,0 +1,184 @@
+/*
+ This file is part of OpenMalaria.
+
+ Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef Hmod_SubPopIndexSuite
+#define Hmod_SubPopIndexSuite
+
+#include <cxxtest/TestSuite.h>
+#include "UnittestUtil.h"
+#include "Population.h"
+#include "interventions/SubPopIndex.h"
+#include <sstream>
+
+using namespace OM;
+using OM::interventions::SubPopIndex;
+using OM::interventions::ComponentId;
+
+/** Tests of SubPopIndex, using a population of humans without any models
+ * (only sub-population memberships are used). */
+class SubPopIndexSuite : public CxxTest::TestSuite
+{
+public:
+    SubPopIndexSuite () : subPop(2), other(5) {}
+
+    void setUp () {
+        UnittestUtil::initTime(1);
+        resetIndex();
+        SubPopIndex::track( subPop );
+        population = newPopulation();
+    }
+    void tearDown () {
+        delete population;
+        resetIndex();
+    }
+
+    void testAddMerge () {
+        // out of order, with repeats
+        deploy( 4, sim::fromDays(5) );
+        deploy( 1, sim::fromDays(5) );
+        deploy( 4, sim::fromDays(5) );
+        deploy( 3, sim::fromDays(5) );
+        size_t exp1[] = { 1, 3, 4 };
+        checkMembers( exp1, 3 );
+        TS_ASSERT_EQUALS( SubPopIndex::memberIds[subPop.id].size(), 3u );
+
+        // merge new additions into the existing sorted list
+        deploy( 0, sim::fromDays(5) );
+        deploy( 3, sim::fromDays(5) );
+        deploy( 2, sim::fromDays(5) );
+        size_t exp2[] = { 0, 1, 2, 3, 4 };
+        checkMembers( exp2, 5 );
+        TS_ASSERT_EQUALS( SubPopIndex::memberIds[subPop.id].size(), 5u );
+
+        // deployments to untracked sub-populations are not indexed
+        population->human( 0 ).reportDeployment( other, sim::fromDays(5) );
+        TS_ASSERT( !SubPopIndex::isTracked( other ) );
+        TS_ASSERT_EQUALS( SubPopIndex::memberIds.size(), subPop.id + 1 );
+    }
+
+    void testExpiredAndDead () {
+        deploy( 0, sim::oneTS() );
+        deploy( 1, sim::fromDays(3) );
+        deploy( 2, sim::oneTS() );
+        deploy( 3, sim::fromDays(3) );
+        deploy( 4, sim::fromDays(3) );
+        UnittestUtil::incrTime( sim::oneTS() );
+        size_t exp1[] = { 1, 3, 4 };
+        checkMembers( exp1, 3 );
+        TS_ASSERT_EQUALS( SubPopIndex::memberIds[subPop.id].size(), 3u );
+
+        // remove (as if dead) the human at index 3; the last moves to index 3
+        vector<char> remove( nHumans, 0 );
+        remove[3] = 1;
+        population->compact( remove );
+        size_t exp2[] = { 1, 3 };
+        checkMembers( exp2, 2 );
+        TS_ASSERT_EQUALS( SubPopIndex::memberIds[subPop.id].size(), 2u );
+
+        // a new deployment makes an expired human a member again
+        deploy( 0, sim::oneTS() );
+        size_t exp3[] = { 0, 1, 3 };
+        checkMembers( exp3, 3 );
+
+        UnittestUtil::incrTime( sim::fromDays(3) );
+        checkMembers( 0, 0 );
+        TS_ASSERT( SubPopIndex::memberIds[subPop.id].empty() );
+    }
+
+    void testRebuildAfterLoad () {
+        deploy( 1, sim::fromDays(5) );
+        deploy( 3, sim::fromDays(2) );
+        deploy( 3, sim::fromDays(5) );
+
+        // write all humans' memberships
+        ostringstream out;
+        for( size_t i = 0; i < nHumans; ++i ){
+            Host::Human& h = population->human( i );
+            const SimTime firstExp = h.m_subPopFirstExp;
+            h.checkpointSubPops( out );
+            TS_ASSERT_EQUALS( h.m_subPopFirstExp, firstExp );     // writing changes nothing
+        }
+
+        // load into a new population, as in a new process: the index is empty
+        // except for a stale addition
+        Population* loaded = newPopulation();
+        resetIndex();
+        SubPopIndex::track( subPop );
+        SubPopIndex::add( subPop, loaded->humanId( 0 ) );
+        istringstream in( out.str() );
+        for( size_t i = 0; i < nHumans; ++i )
+            loaded->human( i ).checkpointSubPops( in );
+        // reading sets the first expiry from the memberships read
+        TS_ASSERT_EQUALS( loaded->human( 0 ).m_subPopFirstExp, sim::future() );
+        TS_ASSERT_EQUALS( loaded->human( 1 ).m_subPopFirstExp,
+                sim::nowOrTs1() + sim::fromDays(5) );
+        TS_ASSERT_EQUALS( loaded->human( 3 ).m_subPopFirstExp,
+                sim::nowOrTs1() + sim::fromDays(5) );   // re-deployment replaced expiry
+
+        SubPopIndex::rebuild( *loaded );
+        for( size_t t = 0; t < SubPopIndex::pending.size(); ++t )
+            TS_ASSERT( SubPopIndex::pending[t].empty() );
+        vector<size_t> indices;
+        SubPopIndex::members( subPop, *loaded, indices );
+        TS_ASSERT_EQUALS( indices.size(), 2u );
+        if( indices.size() == 2 ){
+            TS_ASSERT_EQUALS( indices[0], 1u );
+            TS_ASSERT_EQUALS( indices[1], 3u );
+        }
+        delete loaded;
+    }
+
+private:
+    // Population of nHumans humans with identifiers 1, 4, 7, ... (so that
+    // identifiers and indices differ)
+    Population* newPopulation () {
+        Population* pop = new Population();
+        for( size_t i = 0; i < nHumans; ++i ){
+            SimTime dob = sim::nowOrTs0() - sim::fromDays( 10 * (nHumans - i) );
+            pop->pushHuman( UnittestUtil::createHuman( dob ).release(), 3 * i + 1 );
+        }
+        return pop;
+    }
+
+    static void resetIndex () {
+        SubPopIndex::tracked.clear();
+        SubPopIndex::memberIds.clear();
+        SubPopIndex::pending.clear();
+    }
+
+    void deploy( size_t index, SimTime duration ){
+        population->human( index ).reportDeployment( subPop, duration );
+    }
+
+    void checkMembers( const size_t* expected, size_t n ){
+        vector<size_t> indices;
+        SubPopIndex::members( subPop, *population, indices );
+        TS_ASSERT_EQUALS( indices.size(), n );
+        for( size_t i = 0; i < n && i < indices.size(); ++i )
+            TS_ASSERT_EQUALS( indices[i], expected[i] );
+    }
+
+    static const size_t nHumans = 5;
+    ComponentId subPop, other;
+    Population* population;
+};
+
+#endif